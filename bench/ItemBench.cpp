@@ -0,0 +1,187 @@
+// Checks every filter kernel the CPU can run against the scalar reference, and times the kernels
+// and the LSD radix sort the store uses. Exits nonzero on the first mismatch.
+
+#include "Items/FilterKernels.h"
+#include "Items/RadixSort.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+	using namespace Items::FilterKernels;
+
+	struct Kernel
+	{
+		std::string_view name;
+		kernel_t fn;
+		bool supported;
+	};
+
+	struct Store
+	{
+		explicit Store(std::size_t a_size, std::mt19937& a_rng) :
+			values(a_size),
+			weights(a_size),
+			counts(a_size),
+			traits(a_size)
+		{
+			std::uniform_int_distribution<std::int32_t> value{ -50, 5000 };
+			std::uniform_int_distribution<std::int32_t> count{ -2, 10 };
+			std::uniform_int_distribution<std::uint32_t> trait{ 0, 0xFF };
+			std::uniform_real_distribution<float> weight{ 0.0F, 60.0F };
+			std::bernoulli_distribution weightless{ 0.2 };
+			for (std::size_t i = 0; i < a_size; ++i) {
+				values[i] = value(a_rng);
+				weights[i] = weightless(a_rng) ? 0.0F : weight(a_rng);
+				counts[i] = count(a_rng);
+				traits[i] = trait(a_rng) & trait(a_rng);
+			}
+		}
+
+		[[nodiscard]] Columns Cols() const { return { values.data(), weights.data(), counts.data(), traits.data(), values.size() }; }
+
+		std::vector<std::int32_t> values;
+		std::vector<float> weights;
+		std::vector<std::int32_t> counts;
+		std::vector<std::uint32_t> traits;
+	};
+
+	[[nodiscard]] std::vector<std::uint8_t> Run(kernel_t a_kernel, const Columns& a_cols, const Params& a_params)
+	{
+		std::vector<std::uint8_t> mask((a_cols.size + 7) / 8, 0);
+		Evaluate(a_kernel, a_cols, a_params, mask.data());
+		return mask;
+	}
+
+	[[nodiscard]] bool CheckKernels(std::span<const Kernel> a_kernels, std::mt19937& a_rng)
+	{
+		std::uniform_int_distribution<std::uint32_t> reject{ 0, 0xFF };
+		std::uniform_real_distribution<float> ratio{ -1.0F, 200.0F };
+
+		// Every size up to a few vectors, so each tail length is covered
+		for (std::size_t size = 0; size <= 67; ++size) {
+			for (int round = 0; round < 50; ++round) {
+				const Store store{ size, a_rng };
+				const Params params{ reject(a_rng), round % 3 == 0 ? 0.0F : ratio(a_rng) };
+				const auto expected = Run(EvaluateScalar, store.Cols(), params);
+
+				for (const auto& kernel : a_kernels) {
+					if (kernel.supported && Run(kernel.fn, store.Cols(), params) != expected) {
+						std::printf("FAIL: %.*s differs from scalar at %zu rows\n", static_cast<int>(kernel.name.size()), kernel.name.data(), size);
+						return false;
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+
+	template <class Fn>
+	[[nodiscard]] double Time(std::size_t a_iterations, Fn&& a_fn)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (std::size_t i = 0; i < a_iterations; ++i) {
+			a_fn();
+		}
+		const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+		return elapsed.count() / static_cast<double>(a_iterations);
+	}
+
+	void TimeKernels(std::span<const Kernel> a_kernels, std::mt19937& a_rng)
+	{
+		for (const auto size : { 32u, 256u, 4096u }) {
+			const Store store{ size, a_rng };
+			const Params params{ 0x11, 2.5F };
+			std::vector<std::uint8_t> mask((size + 7) / 8);
+			for (const auto& kernel : a_kernels) {
+				if (!kernel.supported) {
+					continue;
+				}
+
+				const auto ns = Time(20000, [&]() {
+					std::fill(mask.begin(), mask.end(), std::uint8_t{ 0 });
+					Evaluate(kernel.fn, store.Cols(), params, mask.data());
+				});
+				std::printf("filter %-6.*s %5u rows: %10.1f ns\n", static_cast<int>(kernel.name.size()), kernel.name.data(), size, ns);
+			}
+		}
+	}
+
+	[[nodiscard]] bool CheckAndTimeRadixSort(std::mt19937& a_rng)
+	{
+		std::vector<std::uint64_t> keysTmp;
+		std::vector<std::uint32_t> orderTmp;
+		for (const auto size : { 0u, 1u, 32u, 256u, 4096u }) {
+			// Narrow keys share their high bytes, the passes over them are skipped
+			for (const auto bits : { 8u, 24u, 64u }) {
+				std::vector<std::uint64_t> keys(size);
+				for (auto& key : keys) {
+					key = bits == 64 ? (std::uint64_t{ a_rng() } << 32) | a_rng() : a_rng() & ((1ull << bits) - 1);
+				}
+
+				std::vector<std::uint32_t> expected(size);
+				std::iota(expected.begin(), expected.end(), 0u);
+				std::stable_sort(expected.begin(), expected.end(), [&](auto a_lhs, auto a_rhs) { return keys[a_lhs] < keys[a_rhs]; });
+
+				auto sortedKeys = keys;
+				std::vector<std::uint32_t> order(size);
+				std::iota(order.begin(), order.end(), 0u);
+				Items::RadixSort(sortedKeys, order, keysTmp, orderTmp);
+				if (order != expected) {
+					std::printf("FAIL: radix sort differs from stable_sort at %u rows, %u bit keys\n", size, bits);
+					return false;
+				}
+
+				if (size >= 32) {
+					const auto radix = Time(2000, [&]() {
+						sortedKeys = keys;
+						std::iota(order.begin(), order.end(), 0u);
+						Items::RadixSort(sortedKeys, order, keysTmp, orderTmp);
+					});
+					const auto reference = Time(2000, [&]() {
+						std::iota(order.begin(), order.end(), 0u);
+						std::stable_sort(order.begin(), order.end(), [&](auto a_lhs, auto a_rhs) { return keys[a_lhs] < keys[a_rhs]; });
+					});
+					std::printf("sort %5u rows, %2u bit keys: radix %10.1f ns, stable_sort %10.1f ns\n", size, bits, radix, reference);
+				}
+			}
+		}
+
+		return true;
+	}
+}
+
+int main()
+{
+	const bool avx2 = HasAVX2();
+	const bool sse2 = HasSSE2();
+	const Kernel kernels[] = {
+		{ "scalar", EvaluateScalar, true },
+		{ "SSE2", EvaluateSSE, sse2 },
+		{ "AVX2", EvaluateAVX2, avx2 },
+	};
+
+	std::printf("cpuid picks %s\n", avx2 ? "AVX2" : sse2 ? "SSE2" : "scalar");
+	for (const auto& kernel : kernels) {
+		if (!kernel.supported) {
+			std::printf("%.*s unsupported here, not checked\n", static_cast<int>(kernel.name.size()), kernel.name.data());
+		}
+	}
+
+	std::mt19937 rng{ 0x51EE7 };
+	if (!CheckKernels(kernels, rng) || !CheckAndTimeRadixSort(rng)) {
+		return 1;
+	}
+
+	TimeKernels(kernels, rng);
+	std::printf("OK\n");
+	return 0;
+}
@@ -0,0 +1,129 @@
+#include "API/Provider.h"
+
+#include "Items/GFxItem.h"
+
+namespace API
+{
+	// The view hands out the store's flags column as is
+	static_assert(QuickLootAPI::kStolen == Items::kRowStolen);
+	static_assert(QuickLootAPI::kEnchanted == Items::kRowEnchanted);
+	static_assert(QuickLootAPI::kKnownEnchanted == Items::kRowKnownEnchanted);
+	static_assert(QuickLootAPI::kSpecialEnchanted == Items::kRowSpecialEnchanted);
+	static_assert(QuickLootAPI::kRead == Items::kRowRead);
+	static_assert(QuickLootAPI::kDBMNew == Items::kRowDBMNew);
+	static_assert(QuickLootAPI::kDBMFound == Items::kRowDBMFound);
+	static_assert(QuickLootAPI::kDBMDisplayed == Items::kRowDBMDisplayed);
+	static_assert(QuickLootAPI::kHasWeight == Items::kRowHasWeight);
+	static_assert(QuickLootAPI::kInContainer == Items::ItemStore::kInContainer);
+	static_assert(std::is_same_v<RE::FormID, std::uint32_t>);
+
+	const QuickLootAPI::Interface Provider::_interface{
+		QuickLootAPI::kVersion,
+		GetGeneration,
+		AddListener,
+		RemoveListener
+	};
+
+	void Provider::Register()
+	{
+		auto messaging = SKSE::GetMessagingInterface();
+		if (messaging->RegisterListener(nullptr, OnMessage)) {
+			logger::info("Registered {}"sv, typeid(Provider).name());
+		}
+	}
+
+	void Provider::Publish(const Items::ItemStore& a_store, RE::ObjectRefHandle a_container)
+	{
+		const auto order = a_store.Order();
+		const QuickLootAPI::ModelView view{
+			_generation.fetch_add(1, std::memory_order_relaxed) + 1,
+			a_container.native_handle(),
+			static_cast<std::uint32_t>(order.size()),
+			order.data(),
+			a_store.FormIDs().data(),
+			a_store.Counts().data(),
+			a_store.Values().data(),
+			a_store.Weights().data(),
+			a_store.Flags().data()
+		};
+		Notify(view);
+	}
+
+	void Provider::Clear()
+	{
+		const QuickLootAPI::ModelView view{
+			_generation.fetch_add(1, std::memory_order_relaxed) + 1,
+			0,
+			0,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr
+		};
+		Notify(view);
+	}
+
+	void Provider::OnMessage(SKSE::MessagingInterface::Message* a_msg)
+	{
+		if (!a_msg ||
+			a_msg->type != QuickLootAPI::kRequestInterface ||
+			a_msg->dataLen != sizeof(QuickLootAPI::InterfaceRequest) ||
+			!a_msg->data) {
+			return;
+		}
+
+		auto& request = *static_cast<QuickLootAPI::InterfaceRequest*>(a_msg->data);
+		const auto sender = stl::safe_string(a_msg->sender);
+		if (request.version == 0 || request.version > QuickLootAPI::kVersion) {
+			logger::warn("{} asked for API version {}, only {} is available"sv, sender, request.version, QuickLootAPI::kVersion);
+			request.result = nullptr;
+			return;
+		}
+
+		request.result = std::addressof(_interface);
+		logger::info("Handed the API to {}"sv, sender);
+	}
+
+	std::uint64_t Provider::GetGeneration()
+	{
+		return GetSingleton()._generation.load(std::memory_order_relaxed);
+	}
+
+	void Provider::AddListener(QuickLootAPI::ChangeCallback a_callback, void* a_user)
+	{
+		if (!a_callback) {
+			return;
+		}
+
+		auto& self = GetSingleton();
+		std::scoped_lock l{ self._lock };
+		const listener_t listener{ a_callback, a_user };
+		if (std::find(self._listeners.begin(), self._listeners.end(), listener) == self._listeners.end()) {
+			self._listeners.push_back(listener);
+		}
+	}
+
+	void Provider::RemoveListener(QuickLootAPI::ChangeCallback a_callback, void* a_user)
+	{
+		auto& self = GetSingleton();
+		std::scoped_lock l{ self._lock };
+		std::erase(self._listeners, listener_t{ a_callback, a_user });
+	}
+
+	void Provider::Notify(const QuickLootAPI::ModelView& a_view)
+	{
+		{
+			std::scoped_lock l{ _lock };
+			if (_listeners.empty()) {
+				return;
+			}
+			_notifying.assign(_listeners.begin(), _listeners.end());
+		}
+
+		for (const auto& [callback, user] : _notifying) {
+			callback(std::addressof(a_view), user);
+		}
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "API/QuickLootAPI.h"
+#include "Items/ItemStore.h"
+
+namespace API
+{
+	// Serves QuickLootAPI::Interface to other plugins and tells its listeners about the menu's rows.
+	// Publishing hands out views of the store's columns, the listeners run before the store changes again.
+	class Provider
+	{
+	public:
+		[[nodiscard]] static Provider& GetSingleton()
+		{
+			static Provider singleton;
+			return singleton;
+		}
+
+		// Answers interface requests from any plugin, call while the plugin loads
+		static void Register();
+
+		// UI thread only
+		void Publish(const Items::ItemStore& a_store, RE::ObjectRefHandle a_container);
+		void Clear();
+
+	private:
+		using listener_t = std::pair<QuickLootAPI::ChangeCallback, void*>;
+
+		Provider() = default;
+		Provider(const Provider&) = delete;
+		Provider(Provider&&) = delete;
+
+		~Provider() = default;
+
+		Provider& operator=(const Provider&) = delete;
+		Provider& operator=(Provider&&) = delete;
+
+		static void OnMessage(SKSE::MessagingInterface::Message* a_msg);
+
+		static std::uint64_t GetGeneration();
+		static void AddListener(QuickLootAPI::ChangeCallback a_callback, void* a_user);
+		static void RemoveListener(QuickLootAPI::ChangeCallback a_callback, void* a_user);
+
+		void Notify(const QuickLootAPI::ModelView& a_view);
+
+		static const QuickLootAPI::Interface _interface;
+
+		std::mutex _lock;
+		std::vector<listener_t> _listeners;
+		std::vector<listener_t> _notifying;  // copied out so listeners can remove themselves
+		std::atomic_uint64_t _generation{ 0 };
+	};
+}
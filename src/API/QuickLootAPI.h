@@ -0,0 +1,72 @@
+#pragma once
+
+// Public interface for other SKSE plugins, copy this header as is. It depends on nothing but the
+// standard library so it builds against any CommonLib flavour.
+//
+// Request the interface from kPostLoad on, the reply is written synchronously:
+//
+//	QuickLootAPI::InterfaceRequest request{ QuickLootAPI::kVersion, nullptr };
+//	SKSE::GetMessagingInterface()->Dispatch(QuickLootAPI::kRequestInterface, &request, sizeof(request), QuickLootAPI::kPluginName);
+//	if (request.result) { ... }
+//
+// The view points straight into the menu's row columns, nothing is copied. It is only valid during
+// the listener call, which happens on the UI thread once per menu tick that changed the rows, and
+// with an empty view when the menu closes. Keep what you need, not the pointers.
+
+#include <cstdint>
+
+namespace QuickLootAPI
+{
+	inline constexpr std::uint32_t kVersion{ 1 };
+	inline constexpr std::uint32_t kRequestInterface{ 0x514C4150 };  // "QLAP"
+	inline constexpr const char* kPluginName{ "QuickLootEE" };
+
+	enum RowFlag : std::uint32_t
+	{
+		kStolen = 1 << 0,
+		kEnchanted = 1 << 1,
+		kKnownEnchanted = 1 << 2,
+		kSpecialEnchanted = 1 << 3,
+		kRead = 1 << 4,
+		kDBMNew = 1 << 5,
+		kDBMFound = 1 << 6,
+		kDBMDisplayed = 1 << 7,
+		kHasWeight = 1 << 8,
+		kInContainer = 1u << 31  // clear for loose refs listed next to the container
+	};
+
+	// Columns are indexed by row, order lists the rows in display order
+	struct ModelView
+	{
+		std::uint64_t generation;
+		std::uint32_t container;  // native RE::ObjectRefHandle, 0 once the menu closed
+		std::uint32_t size;       // displayed rows, the length of order
+		const std::uint32_t* order;
+		const std::uint32_t* formID;
+		const std::int32_t* count;
+		const std::int32_t* value;
+		const float* weight;
+		const std::uint32_t* flags;  // RowFlag
+	};
+
+	using ChangeCallback = void (*)(const ModelView* a_view, void* a_user);
+
+	struct Interface
+	{
+		std::uint32_t version;
+
+		// Bumped on every change the listeners are told about, safe to read from any thread
+		std::uint64_t (*GetGeneration)();
+
+		// The pair identifies the listener, adding it twice is a no-op
+		void (*AddListener)(ChangeCallback a_callback, void* a_user);
+		void (*RemoveListener)(ChangeCallback a_callback, void* a_user);
+	};
+
+	// Sent as the message data, result stays null when the version is not supported
+	struct InterfaceRequest
+	{
+		std::uint32_t version;
+		const Interface* result;
+	};
+}
@@ -0,0 +1,170 @@
+#include "Area/LootableGrid.h"
+
+#include "Diagnostics/Watchdog.h"
+
+namespace Area
+{
+	RE::TESObjectREFRPtr LootableGrid::ResolveLootable(RE::TESObjectREFR& a_ref)
+	{
+		const auto obj = a_ref.GetObjectReference();
+		if (!obj) {
+			return nullptr;
+		}
+
+		if (obj->Is(RE::FormType::Activator)) {
+			auto ashPile = a_ref.extraList.GetAshPileRef().get();
+			return ashPile && IsLootable(*ashPile) ? ashPile : RE::TESObjectREFRPtr{};
+		}
+
+		return IsLootable(a_ref) ? RE::TESObjectREFRPtr{ std::addressof(a_ref) } : RE::TESObjectREFRPtr{};
+	}
+
+	void LootableGrid::OnLifeStateChanged(RE::Actor& a_actor)
+	{
+		if (IsLootable(a_actor)) {
+			Insert(a_actor, a_actor.GetPosition());
+		} else {
+			Remove(a_actor.GetFormID());
+		}
+	}
+
+	void LootableGrid::Clear()
+	{
+		std::scoped_lock l{ _lock };
+		_cells.clear();
+		_index.clear();
+	}
+
+	void LootableGrid::Query(const RE::NiPoint3& a_center, float a_radius, std::vector<RE::ObjectRefHandle>& a_out)
+	{
+		// A body knocked out of its grid cell since it was indexed is still found one cell further out
+		const auto reach = a_radius + CELL_SIZE;
+		std::vector<std::pair<float, RE::ObjectRefHandle>> found;
+		std::vector<std::pair<RE::TESObjectREFRPtr, RE::NiPoint3>> moved;
+		const auto radiusSq = a_radius * a_radius;
+		const auto [minX, maxX] = std::make_pair(Coord(a_center.x - reach), Coord(a_center.x + reach));
+		const auto [minY, maxY] = std::make_pair(Coord(a_center.y - reach), Coord(a_center.y + reach));
+
+		{
+			std::scoped_lock l{ _lock };
+			for (auto x = minX; x <= maxX; ++x) {
+				for (auto y = minY; y <= maxY; ++y) {
+					const auto key = Key(x, y);
+					const auto it = _cells.find(key);
+					if (it == _cells.end()) {
+						continue;
+					}
+
+					for (const auto& entry : it->second) {
+						const auto ref = entry.handle.get();
+						if (!ref) {
+							continue;
+						}
+
+						const auto position = ref->GetPosition();
+						if (Key(Coord(position.x), Coord(position.y)) != key) {
+							moved.emplace_back(ref, position);
+						}
+
+						const auto distSq = a_center.GetSquaredDistance(position);
+						if (distSq <= radiusSq) {
+							found.emplace_back(distSq, entry.handle);
+						}
+					}
+				}
+			}
+		}
+
+		for (const auto& [ref, position] : moved) {
+			Insert(*ref, position);
+		}
+
+		std::sort(found.begin(), found.end(), [](auto&& a_lhs, auto&& a_rhs) {
+			return a_lhs.first < a_rhs.first;
+		});
+		for (const auto& [distSq, handle] : found) {
+			a_out.push_back(handle);
+		}
+	}
+
+	auto LootableGrid::ProcessEvent(const RE::TESCellAttachDetachEvent* a_event, RE::BSTEventSource<RE::TESCellAttachDetachEvent>*)
+		-> EventResult
+	{
+		Diagnostics::Watchdog::Scope watch{ "LootableGrid::TESCellAttachDetachEvent"sv };
+
+		if (a_event && a_event->reference) {
+			OnAttachChanged(*a_event->reference, a_event->attached);
+		}
+		return EventResult::kContinue;
+	}
+
+	// Sent when a ref moves into or out of the attached cells on its own, a body carried off by a
+	// ragdoll or a container moved by a script
+	auto LootableGrid::ProcessEvent(const RE::TESMoveAttachDetachEvent* a_event, RE::BSTEventSource<RE::TESMoveAttachDetachEvent>*)
+		-> EventResult
+	{
+		Diagnostics::Watchdog::Scope watch{ "LootableGrid::TESMoveAttachDetachEvent"sv };
+
+		if (a_event && a_event->movedRef) {
+			OnAttachChanged(*a_event->movedRef, a_event->isCellAttached);
+		}
+		return EventResult::kContinue;
+	}
+
+	auto LootableGrid::ProcessEvent(const RE::TESFormDeleteEvent* a_event, RE::BSTEventSource<RE::TESFormDeleteEvent>*)
+		-> EventResult
+	{
+		Diagnostics::Watchdog::Scope watch{ "LootableGrid::TESFormDeleteEvent"sv };
+
+		if (a_event) {
+			Remove(a_event->formID);
+		}
+		return EventResult::kContinue;
+	}
+
+	void LootableGrid::OnAttachChanged(RE::TESObjectREFR& a_ref, bool a_attached)
+	{
+		if (const auto lootable = ResolveLootable(a_ref); lootable) {
+			if (a_attached) {
+				Insert(*lootable, a_ref.GetPosition());
+			} else {
+				Remove(lootable->GetFormID());
+			}
+		} else if (!a_attached) {
+			Remove(a_ref.GetFormID());
+		}
+	}
+
+	void LootableGrid::Insert(RE::TESObjectREFR& a_lootable, const RE::NiPoint3& a_position)
+	{
+		const auto formID = a_lootable.GetFormID();
+		const auto key = Key(Coord(a_position.x), Coord(a_position.y));
+		const auto handle = a_lootable.GetHandle();
+
+		std::scoped_lock l{ _lock };
+		if (const auto it = _index.find(formID); it != _index.end()) {
+			auto& cell = _cells[it->second];
+			std::erase_if(cell, [&](auto&& a_entry) { return a_entry.formID == formID; });
+		}
+
+		_cells[key].push_back({ formID, handle });
+		_index.insert_or_assign(formID, key);
+	}
+
+	void LootableGrid::Remove(RE::FormID a_formID)
+	{
+		std::scoped_lock l{ _lock };
+		const auto it = _index.find(a_formID);
+		if (it == _index.end()) {
+			return;
+		}
+
+		if (const auto cell = _cells.find(it->second); cell != _cells.end()) {
+			std::erase_if(cell->second, [&](auto&& a_entry) { return a_entry.formID == a_formID; });
+			if (cell->second.empty()) {
+				_cells.erase(cell);
+			}
+		}
+		_index.erase(it);
+	}
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+namespace Area
+{
+	// Spatial hash of the lootable refs in the attached cells, so a radius query only looks at the
+	// grid cells it overlaps. Kept current from cell and ref attach/detach, form delete and life state
+	// changes, a query reads the positions again since bodies keep moving after they are indexed.
+	class LootableGrid :
+		public RE::BSTEventSink<RE::TESCellAttachDetachEvent>,
+		public RE::BSTEventSink<RE::TESMoveAttachDetachEvent>,
+		public RE::BSTEventSink<RE::TESFormDeleteEvent>
+	{
+	public:
+		[[nodiscard]] static LootableGrid* GetSingleton()
+		{
+			static LootableGrid singleton;
+			return std::addressof(singleton);
+		}
+
+		static void Register()
+		{
+			auto scripts = RE::ScriptEventSourceHolder::GetSingleton();
+			if (scripts) {
+				scripts->AddEventSink<RE::TESCellAttachDetachEvent>(GetSingleton());
+				scripts->AddEventSink<RE::TESMoveAttachDetachEvent>(GetSingleton());
+				scripts->AddEventSink<RE::TESFormDeleteEvent>(GetSingleton());
+				logger::info("Registered {}"sv, typeid(LootableGrid).name());
+			}
+		}
+
+		// Dead actors that aren't summons and anything else with a container
+		[[nodiscard]] static bool IsLootable(RE::TESObjectREFR& a_ref)
+		{
+			//const bool disable_for_animals = Settings::DisableForAnimals();
+
+			if (const auto actor = a_ref.As<RE::Actor>(); actor) {
+				//auto dobj = RE::BGSDefaultObjectManager::GetSingleton();
+				//auto animal_keyword = dobj->GetObject<RE::BGSKeyword>(RE::DEFAULT_OBJECT::kKeywordAnimal);
+
+				if (!actor->IsDead()
+					|| actor->IsSummoned())
+					//|| (disable_for_animals && actor->GetRace()->HasKeyword(animal_keyword)))
+				{
+					return false;
+				}
+			}
+
+			return a_ref.HasContainer();
+		}
+
+		// The ref the menu would open for a_ref, looking through ash piles to their corpse
+		[[nodiscard]] static RE::TESObjectREFRPtr ResolveLootable(RE::TESObjectREFR& a_ref);
+
+		void OnLifeStateChanged(RE::Actor& a_actor);
+
+		// Call before a save loads or a new game starts, the refs of the old world detach without events
+		void Clear();
+
+		// Appends the lootables within a_radius of a_center, nearest first. Main thread only, the refs'
+		// positions are read and moved entries put back in the right cell
+		void Query(const RE::NiPoint3& a_center, float a_radius, std::vector<RE::ObjectRefHandle>& a_out);
+
+	protected:
+		using EventResult = RE::BSEventNotifyControl;
+
+		EventResult ProcessEvent(const RE::TESCellAttachDetachEvent* a_event, RE::BSTEventSource<RE::TESCellAttachDetachEvent>*) override;
+		EventResult ProcessEvent(const RE::TESMoveAttachDetachEvent* a_event, RE::BSTEventSource<RE::TESMoveAttachDetachEvent>*) override;
+		EventResult ProcessEvent(const RE::TESFormDeleteEvent* a_event, RE::BSTEventSource<RE::TESFormDeleteEvent>*) override;
+
+	private:
+		struct Entry
+		{
+			RE::FormID formID;
+			RE::ObjectRefHandle handle;
+		};
+
+		LootableGrid() = default;
+		LootableGrid(const LootableGrid&) = delete;
+		LootableGrid(LootableGrid&&) = delete;
+
+		~LootableGrid() = default;
+
+		LootableGrid& operator=(const LootableGrid&) = delete;
+		LootableGrid& operator=(LootableGrid&&) = delete;
+
+		[[nodiscard]] static std::int32_t Coord(float a_value) noexcept
+		{
+			return static_cast<std::int32_t>(std::floor(a_value / CELL_SIZE));
+		}
+
+		[[nodiscard]] static std::uint64_t Key(std::int32_t a_x, std::int32_t a_y) noexcept
+		{
+			return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(a_x)) << 32) | static_cast<std::uint32_t>(a_y);
+		}
+
+		void OnAttachChanged(RE::TESObjectREFR& a_ref, bool a_attached);
+		void Insert(RE::TESObjectREFR& a_lootable, const RE::NiPoint3& a_position);
+		void Remove(RE::FormID a_formID);
+
+		static constexpr float CELL_SIZE{ 1024.0F };  // game units
+
+		mutable std::mutex _lock;
+		std::unordered_map<std::uint64_t, std::vector<Entry>> _cells;
+		std::unordered_map<RE::FormID, std::uint64_t> _index;  // ref to grid cell
+	};
+}
@@ -1,17 +1,31 @@
 #include "ContainerChangedHandler.h"
 
+#include "Diagnostics/EventTrace.h"
+#include "Diagnostics/Watchdog.h"
 #include "Loot.h"
 
 auto ContainerChangedHandler::ProcessEvent(const RE::TESContainerChangedEvent* a_event, RE::BSTEventSource<RE::TESContainerChangedEvent>*)
 	-> EventResult
 {
+	Diagnostics::Watchdog::Scope watch{ "ContainerChangedHandler::TESContainerChangedEvent"sv };
+
 	auto container = _container.get();
-	if (a_event &&
-		container &&
-		(a_event->oldContainer == container->GetFormID() ||
-			a_event->newContainer == container->GetFormID())) {
+	if (!a_event || !container) {
+		return EventResult::kContinue;
+	}
+
+	const auto formID = container->GetFormID();
+	const bool removed = a_event->oldContainer == formID;
+	const bool added = a_event->newContainer == formID;
+	if (removed != added) {
+		InventoryDelta delta;
+		delta.object = a_event->baseObj;
+		delta.count = added ? a_event->itemCount : -a_event->itemCount;
+		delta.rescan = static_cast<bool>(a_event->reference);  // dropped or picked up world references
+		Diagnostics::EventTrace::RecordContainerDelta(delta);
+
 		auto& loot = Loot::GetSingleton();
-		loot.RefreshInventory();
+		loot.RefreshInventory(delta);
 	}
 
 	return EventResult::kContinue;
@@ -1,5 +1,13 @@
 #pragma once
 
+// A signed count change for one base object, as carried by TESContainerChangedEvent
+struct InventoryDelta
+{
+	RE::FormID object{ 0 };
+	std::int32_t count{ 0 };
+	bool rescan{ false };  // the change can't be applied to the current model
+};
+
 class ContainerChangedHandler :
 	public RE::BSTEventSink<RE::TESContainerChangedEvent>
 {
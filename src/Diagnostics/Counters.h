@@ -0,0 +1,63 @@
+#pragma once
+
+namespace Diagnostics
+{
+	// Cheap monotonic counters for the menu's work, dumped to the log on request
+	class Counters
+	{
+	public:
+		enum Counter : std::size_t
+		{
+			kContainersSet,
+			kInventoryRebuilds,
+			kDeltaUpdates,
+			kDwellSkipped,  // targets the crosshair left before their rows were built
+			kClassifyBatches,  // models classified on the worker threads
+
+			kTotal
+		};
+
+		static void Increment(Counter a_counter) noexcept
+		{
+			GetSingleton()._values[a_counter].fetch_add(1, std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] static std::uint64_t Get(Counter a_counter) noexcept
+		{
+			return GetSingleton()._values[a_counter].load(std::memory_order_relaxed);
+		}
+
+		static void Dump()
+		{
+			static constexpr std::array<std::string_view, kTotal> names{
+				"containers set"sv,
+				"inventory rebuilds"sv,
+				"delta updates"sv,
+				"dwell skipped"sv,
+				"classify batches"sv,
+			};
+
+			for (std::size_t i = 0; i < kTotal; ++i) {
+				logger::info("{}: {}"sv, names[i], Get(static_cast<Counter>(i)));
+			}
+		}
+
+	private:
+		Counters() = default;
+		Counters(const Counters&) = delete;
+		Counters(Counters&&) = delete;
+
+		~Counters() = default;
+
+		Counters& operator=(const Counters&) = delete;
+		Counters& operator=(Counters&&) = delete;
+
+		[[nodiscard]] static Counters& GetSingleton()
+		{
+			static Counters singleton;
+			return singleton;
+		}
+
+		std::array<std::atomic_uint64_t, kTotal> _values{};
+	};
+}
@@ -0,0 +1,602 @@
+#include "Diagnostics/EventTrace.h"
+
+#include "Events/Events.h"
+#include "Input/InputListeners.h"
+#include "Items/InventoryView.h"
+#include "Loot.h"
+
+#include <fstream>
+
+namespace Diagnostics
+{
+	namespace
+	{
+		constexpr std::uint32_t MAGIC{ 0x54454C51 };  // "QLET"
+		constexpr std::uint16_t FORMAT{ 1 };
+		constexpr double SLOW_EVENT_US{ 1000.0 };  // replayed events above this are logged one by one
+
+		using contents_t = std::vector<std::pair<RE::FormID, std::int32_t>>;
+
+		// What the menu would list for the ref, by form ID, so a replay can tell whether the world still matches
+		[[nodiscard]] contents_t Contents(RE::TESObjectREFR* a_ref)
+		{
+			contents_t result;
+			if (a_ref) {
+				Items::InventoryView view;
+				view.ForEach(
+					*a_ref,
+					[](const RE::TESBoundObject&) { return true; },
+					[&](const Items::InventoryView::Entry& a_entry) {
+						result.emplace_back(a_entry.object->GetFormID(), a_entry.count);
+					});
+				std::sort(result.begin(), result.end());
+			}
+			return result;
+		}
+
+		class Recorder
+		{
+		public:
+			void Begin(EventTrace::Kind a_kind)
+			{
+				const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+				Put(a_kind);
+				Put(static_cast<std::uint32_t>(elapsed.count()));
+			}
+
+			template <class T>
+			void Put(const T& a_value)
+			{
+				static_assert(std::is_trivially_copyable_v<T>);
+				const auto bytes = std::as_bytes(std::span{ std::addressof(a_value), 1 });
+				buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+			}
+
+			void PutString(std::string_view a_str)
+			{
+				const auto size = std::min<std::size_t>(a_str.size(), std::numeric_limits<std::uint16_t>::max());
+				Put(static_cast<std::uint16_t>(size));
+				const auto bytes = std::as_bytes(std::span{ a_str.data(), size });
+				buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+			}
+
+			void PutContents(const contents_t& a_contents)
+			{
+				Put(static_cast<std::uint32_t>(a_contents.size()));
+				for (const auto& [formID, count] : a_contents) {
+					Put(formID);
+					Put(count);
+				}
+			}
+
+			std::mutex lock;
+			std::vector<std::byte> buffer;
+			std::chrono::steady_clock::time_point start;
+		};
+
+		[[nodiscard]] Recorder& GetRecorder()
+		{
+			static Recorder recorder;
+			return recorder;
+		}
+
+		class Reader
+		{
+		public:
+			explicit Reader(std::span<const std::byte> a_data) noexcept :
+				_data(a_data)
+			{}
+
+			[[nodiscard]] bool Done() const noexcept { return _pos >= _data.size(); }
+
+			template <class T>
+			[[nodiscard]] bool Get(T& a_value) noexcept
+			{
+				static_assert(std::is_trivially_copyable_v<T>);
+				if (_data.size() - _pos < sizeof(T)) {
+					return false;
+				}
+				std::memcpy(std::addressof(a_value), _data.data() + _pos, sizeof(T));
+				_pos += sizeof(T);
+				return true;
+			}
+
+			[[nodiscard]] bool GetString(std::string& a_str)
+			{
+				std::uint16_t size = 0;
+				if (!Get(size) || _data.size() - _pos < size) {
+					return false;
+				}
+				a_str.assign(reinterpret_cast<const char*>(_data.data() + _pos), size);
+				_pos += size;
+				return true;
+			}
+
+			[[nodiscard]] bool GetContents(contents_t& a_contents)
+			{
+				std::uint32_t size = 0;
+				if (!Get(size)) {
+					return false;
+				}
+
+				a_contents.resize(size);
+				for (auto& [formID, count] : a_contents) {
+					if (!Get(formID) || !Get(count)) {
+						return false;
+					}
+				}
+				return true;
+			}
+
+		private:
+			std::span<const std::byte> _data;
+			std::size_t _pos{ 0 };
+		};
+
+		[[nodiscard]] std::string_view KindName(EventTrace::Kind a_kind)
+		{
+			static constexpr std::array<std::string_view, static_cast<std::size_t>(EventTrace::Kind::kTotal)> names{
+				"crosshair"sv,
+				"lock changed"sv,
+				"combat"sv,
+				"container delta"sv,
+				"menu open/close"sv,
+				"button"sv,
+			};
+
+			const auto index = static_cast<std::size_t>(a_kind);
+			return index < names.size() ? names[index] : "unknown"sv;
+		}
+
+		template <class Event, class Sink>
+		void Dispatch(Sink& a_sink, const Event& a_event)
+		{
+			// The sinks' overrides are protected, the base's entry point is public
+			static_cast<RE::BSTEventSink<Event>&>(a_sink).ProcessEvent(std::addressof(a_event), nullptr);
+		}
+
+		struct Stats
+		{
+			std::size_t count{ 0 };
+			double total{ 0.0 };
+			double max{ 0.0 };
+		};
+
+		// A decoded trace being fed back in. An event is charged its own dispatch and the menu ticks
+		// that ran before the next one was fed, which is where the work it queued is done
+		class Replayer
+		{
+		public:
+			struct Event
+			{
+				EventTrace::Kind kind;
+				std::uint32_t time;
+				std::function<bool()> matches;  // whether the world still looks as recorded, checked untimed
+				std::function<void()> dispatch;
+			};
+
+			// Dispatches the next event after booking the last one, false once the trace is used up
+			bool Feed()
+			{
+				Settle();
+				if (_next >= events.size()) {
+					return false;
+				}
+
+				_current = _next++;
+				_ticked = false;
+				if (const auto& matches = events[*_current].matches; matches && !matches()) {
+					++mismatched;
+				}
+
+				const auto begin = std::chrono::steady_clock::now();
+				events[*_current].dispatch();
+				_charged = std::chrono::steady_clock::now() - begin;
+				return true;
+			}
+
+			void Charge(std::chrono::steady_clock::duration a_tick) noexcept
+			{
+				if (_current) {
+					_charged += a_tick;
+					_ticked = true;
+				}
+			}
+
+			// The event fed last hasn't seen a menu tick yet
+			[[nodiscard]] bool Waiting() const noexcept { return _current && !_ticked; }
+
+			void Report()
+			{
+				Settle();
+				logger::info("Replayed {} of {} events{}"sv, _next, events.size(), truncated ? " (trace truncated)"sv : ""sv);
+				for (std::size_t i = 0; i < _stats.size(); ++i) {
+					const auto& [count, total, max] = _stats[i];
+					if (count > 0) {
+						logger::info("  {}: {} events, {:.1f}us avg, {:.1f}us max"sv, KindName(static_cast<EventTrace::Kind>(i)), count, total / static_cast<double>(count), max);
+					}
+				}
+				if (mismatched > 0) {
+					logger::info("  {} events found the world different from the recording"sv, mismatched);
+				}
+			}
+
+			std::vector<Event> events;
+			std::size_t mismatched{ 0 };
+			bool truncated{ false };
+			Input::Listeners listeners;  // never registered with the input manager, only fed from here
+
+		private:
+			void Settle()
+			{
+				if (!_current) {
+					return;
+				}
+
+				const auto& event = events[*_current];
+				const std::chrono::duration<double, std::micro> elapsed = _charged;
+				auto& entry = _stats[static_cast<std::size_t>(event.kind)];
+				++entry.count;
+				entry.total += elapsed.count();
+				entry.max = std::max(entry.max, elapsed.count());
+				if (elapsed.count() > SLOW_EVENT_US) {
+					logger::info("#{} {} at {}ms took {:.1f}us"sv, *_current, KindName(event.kind), event.time, elapsed.count());
+				}
+				_current.reset();
+			}
+
+			std::array<Stats, static_cast<std::size_t>(EventTrace::Kind::kTotal)> _stats{};
+			std::optional<std::size_t> _current;
+			std::size_t _next{ 0 };
+			std::chrono::steady_clock::duration _charged{};
+			bool _ticked{ false };
+		};
+
+		struct ReplayState
+		{
+			std::mutex lock;
+			std::unique_ptr<Replayer> replayer;
+		};
+
+		[[nodiscard]] ReplayState& GetReplayState()
+		{
+			static ReplayState state;
+			return state;
+		}
+	}
+
+	void EventTrace::WriteCrosshair(RE::TESObjectREFR* a_ref)
+	{
+		const auto contents = Contents(a_ref);
+
+		auto& recorder = GetRecorder();
+		std::scoped_lock l{ recorder.lock };
+		recorder.Begin(Kind::kCrosshair);
+		recorder.Put(a_ref ? a_ref->GetFormID() : RE::FormID{ 0 });
+		recorder.PutContents(contents);
+	}
+
+	void EventTrace::WriteLockChanged(const RE::TESObjectREFR& a_ref)
+	{
+		auto& recorder = GetRecorder();
+		std::scoped_lock l{ recorder.lock };
+		recorder.Begin(Kind::kLockChanged);
+		recorder.Put(a_ref.GetFormID());
+		recorder.Put(static_cast<std::uint8_t>(a_ref.IsLocked()));
+	}
+
+	void EventTrace::WriteCombat(const RE::TESCombatEvent& a_event)
+	{
+		auto& recorder = GetRecorder();
+		std::scoped_lock l{ recorder.lock };
+		recorder.Begin(Kind::kCombat);
+		recorder.Put(a_event.actor ? a_event.actor->GetFormID() : RE::FormID{ 0 });
+		recorder.Put(a_event.targetActor ? a_event.targetActor->GetFormID() : RE::FormID{ 0 });
+		recorder.Put(static_cast<std::uint32_t>(a_event.newState.underlying()));
+	}
+
+	void EventTrace::WriteContainerDelta(const InventoryDelta& a_delta)
+	{
+		auto& recorder = GetRecorder();
+		std::scoped_lock l{ recorder.lock };
+		recorder.Begin(Kind::kContainerDelta);
+		recorder.Put(a_delta.object);
+		recorder.Put(a_delta.count);
+		recorder.Put(static_cast<std::uint8_t>(a_delta.rescan));
+	}
+
+	void EventTrace::WriteMenuOpenClose(const RE::MenuOpenCloseEvent& a_event)
+	{
+		auto& recorder = GetRecorder();
+		std::scoped_lock l{ recorder.lock };
+		recorder.Begin(Kind::kMenuOpenClose);
+		recorder.Put(static_cast<std::uint8_t>(a_event.opening));
+		recorder.PutString(a_event.menuName);
+	}
+
+	void EventTrace::WriteInput(const RE::InputEvent* a_event)
+	{
+		auto& recorder = GetRecorder();
+		std::scoped_lock l{ recorder.lock };
+		for (auto event = a_event; event; event = event->next) {
+			const auto button = event->AsButtonEvent();
+			if (!button) {
+				continue;
+			}
+
+			recorder.Begin(Kind::kButton);
+			recorder.Put(static_cast<std::uint32_t>(button->GetDevice()));
+			recorder.Put(button->GetIDCode());
+			recorder.Put(button->Value());
+			recorder.Put(button->HeldDuration());
+			recorder.PutString(button->QUserEvent());
+		}
+	}
+
+	void EventTrace::ToggleRecording()
+	{
+		auto& recorder = GetRecorder();
+		if (!_recording.load()) {
+			{
+				std::scoped_lock l{ recorder.lock };
+				recorder.buffer.clear();
+				recorder.start = std::chrono::steady_clock::now();
+				recorder.Put(MAGIC);
+				recorder.Put(FORMAT);
+			}
+			_recording.store(true);
+			logger::info("Recording events"sv);
+			return;
+		}
+
+		_recording.store(false);
+		const auto path = Path();
+		if (!path) {
+			return;
+		}
+
+		std::scoped_lock l{ recorder.lock };
+		std::ofstream out{ *path, std::ios::binary | std::ios::trunc };
+		out.write(reinterpret_cast<const char*>(recorder.buffer.data()), static_cast<std::streamsize>(recorder.buffer.size()));
+		logger::info("Wrote {} byte event trace to {}"sv, recorder.buffer.size(), path->string());
+	}
+
+	// Runs on the live game: takes and input are applied for real, menu open/close events are only
+	// counted since sending them would reach every other plugin's sinks
+	void EventTrace::Replay()
+	{
+		auto& state = GetReplayState();
+		{
+			std::scoped_lock l{ state.lock };
+			if (state.replayer) {
+				logger::info("Replay stopped"sv);
+				EndReplay();
+				return;
+			}
+		}
+
+		if (Recording()) {
+			logger::warn("Stop recording before replaying a trace"sv);
+			return;
+		}
+
+		const auto path = Path();
+		std::ifstream in{ path ? *path : std::filesystem::path{}, std::ios::binary };
+		if (!in) {
+			logger::warn("No event trace to replay"sv);
+			return;
+		}
+
+		std::vector<std::byte> data;
+		in.seekg(0, std::ios::end);
+		data.resize(static_cast<std::size_t>(in.tellg()));
+		in.seekg(0);
+		in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+		Reader reader{ data };
+		std::uint32_t magic = 0;
+		std::uint16_t format = 0;
+		if (!reader.Get(magic) || !reader.Get(format) || magic != MAGIC || format != FORMAT) {
+			logger::warn("Event trace has an unknown format"sv);
+			return;
+		}
+
+		auto replayer = std::make_unique<Replayer>();
+		auto& listeners = replayer->listeners;
+		auto& truncated = replayer->truncated;
+
+		const auto lookup = [](RE::FormID a_formID) {
+			return a_formID ? RE::TESForm::LookupByID<RE::TESObjectREFR>(a_formID) : nullptr;
+		};
+
+		while (!reader.Done()) {
+			Kind kind{};
+			std::uint32_t time = 0;
+			if (!reader.Get(kind) || !reader.Get(time) || kind >= Kind::kTotal) {
+				truncated = true;
+				break;
+			}
+
+			// Decoded up front, only the handlers and the menu ticks after them are measured
+			std::function<bool()> matches;
+			std::function<void()> dispatch;
+			switch (kind) {
+			case Kind::kCrosshair:
+				{
+					RE::FormID formID = 0;
+					contents_t contents;
+					if (!reader.Get(formID) || !reader.GetContents(contents)) {
+						truncated = true;
+						break;
+					}
+
+					// Looked up when fed, the ref may have unloaded since the replay started
+					matches = [lookup, formID, contents = std::move(contents)]() {
+						return Contents(lookup(formID)) == contents;
+					};
+
+					dispatch = [lookup, formID]() {
+						const SKSE::CrosshairRefEvent event{ RE::NiPointer<RE::TESObjectREFR>{ lookup(formID) } };
+						Dispatch(*Events::CrosshairRefManager::GetSingleton(), event);
+					};
+				}
+				break;
+			case Kind::kLockChanged:
+				{
+					RE::FormID formID = 0;
+					std::uint8_t locked = 0;
+					if (!reader.Get(formID) || !reader.Get(locked)) {
+						truncated = true;
+						break;
+					}
+
+					matches = [lookup, formID, locked]() {
+						const auto ref = lookup(formID);
+						return ref && ref->IsLocked() == (locked != 0);
+					};
+
+					dispatch = [lookup, formID]() {
+						RE::TESLockChangedEvent event;
+						event.lockedObject.reset(lookup(formID));
+						Dispatch(*Events::CrosshairRefManager::GetSingleton(), event);
+					};
+				}
+				break;
+			case Kind::kCombat:
+				{
+					RE::FormID actor = 0;
+					RE::FormID target = 0;
+					std::uint32_t state = 0;
+					if (!reader.Get(actor) || !reader.Get(target) || !reader.Get(state)) {
+						truncated = true;
+						break;
+					}
+
+					dispatch = [lookup, actor, target, state]() {
+						RE::TESCombatEvent event;
+						event.actor.reset(lookup(actor));
+						event.targetActor.reset(lookup(target));
+						event.newState = static_cast<RE::ACTOR_COMBAT_STATE>(state);
+						Dispatch(*Events::CombatManager::GetSingleton(), event);
+					};
+				}
+				break;
+			case Kind::kContainerDelta:
+				{
+					InventoryDelta delta;
+					std::uint8_t rescan = 0;
+					if (!reader.Get(delta.object) || !reader.Get(delta.count) || !reader.Get(rescan)) {
+						truncated = true;
+						break;
+					}
+
+					delta.rescan = rescan != 0;
+					dispatch = [delta]() { Loot::GetSingleton().RefreshInventory(delta); };
+				}
+				break;
+			case Kind::kMenuOpenClose:
+				{
+					std::uint8_t opening = 0;
+					std::string name;
+					if (!reader.Get(opening) || !reader.GetString(name)) {
+						truncated = true;
+						break;
+					}
+					dispatch = []() {};
+				}
+				break;
+			case Kind::kButton:
+				{
+					std::uint32_t device = 0;
+					std::uint32_t idCode = 0;
+					float value = 0.0F;
+					float held = 0.0F;
+					std::string userEvent;
+					if (!reader.Get(device) || !reader.Get(idCode) || !reader.Get(value) || !reader.Get(held) || !reader.GetString(userEvent)) {
+						truncated = true;
+						break;
+					}
+
+					dispatch = [&listeners, device, idCode, value, held, userEvent]() {
+						const auto button = RE::ButtonEvent::Create(static_cast<RE::INPUT_DEVICE>(device), userEvent.c_str(), idCode, value, held);
+						RE::InputEvent* const event = button;
+						Dispatch(listeners, event);
+						RE::free(button);
+					};
+				}
+				break;
+			default:
+				break;
+			}
+
+			if (truncated) {
+				break;
+			}
+
+			replayer->events.push_back({ kind, time, std::move(matches), std::move(dispatch) });
+		}
+
+		logger::info("Replaying {} events, one per menu tick, replay again to stop"sv, replayer->events.size());
+		{
+			std::scoped_lock l{ state.lock };
+			state.replayer = std::move(replayer);
+			_replaying.store(true);
+		}
+		QueueClosedFeed();
+	}
+
+	void EventTrace::BeginTick()
+	{
+		auto& state = GetReplayState();
+		std::scoped_lock l{ state.lock };
+		if (state.replayer && !state.replayer->Waiting() && !state.replayer->Feed()) {
+			EndReplay();
+		}
+	}
+
+	void EventTrace::EndTick(std::chrono::steady_clock::duration a_elapsed)
+	{
+		auto& state = GetReplayState();
+		std::scoped_lock l{ state.lock };
+		if (state.replayer) {
+			state.replayer->Charge(a_elapsed);
+		}
+	}
+
+	void EventTrace::QueueClosedFeed()
+	{
+		auto task = SKSE::GetTaskInterface();
+		task->AddTask([]() { FeedClosed(); });
+	}
+
+	// Events that leave the menu closed queue no work for it, they run back to back until one does
+	void EventTrace::FeedClosed()
+	{
+		auto& state = GetReplayState();
+		std::scoped_lock l{ state.lock };
+		auto& loot = Loot::GetSingleton();
+		while (state.replayer && !loot.HasMenuWork()) {
+			if (!state.replayer->Feed()) {
+				EndReplay();
+			}
+		}
+	}
+
+	// Called with the replay state locked
+	void EventTrace::EndReplay()
+	{
+		auto& state = GetReplayState();
+		state.replayer->Report();
+		state.replayer.reset();
+		_replaying.store(false);
+	}
+
+	std::optional<std::filesystem::path> EventTrace::Path()
+	{
+		auto path = logger::log_directory();
+		if (path) {
+			*path /= fmt::format("{}.trace"sv, Plugin::NAME);
+		}
+		return path;
+	}
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "ContainerChangedHandler.h"
+
+namespace Diagnostics
+{
+	// Debug builds only. Records the events that drive the menu, with the contents of every container
+	// the crosshair lands on, into a compact binary trace, and replays a trace through the same sinks
+	// and Loot entry points, timing each event. Release builds compile every Record call away.
+	class EventTrace
+	{
+	public:
+		// Wraps the menu's tick. While a replay runs the tick feeds it the next event and is charged to
+		// that event, so an event is timed together with the work it queued for the menu
+		class TickScope
+		{
+		public:
+			TickScope()
+			{
+				if (Replaying()) {
+					BeginTick();
+					_start = std::chrono::steady_clock::now();
+				}
+			}
+
+			~TickScope()
+			{
+				if (_start != std::chrono::steady_clock::time_point{}) {
+					EndTick(std::chrono::steady_clock::now() - _start);
+				}
+			}
+
+			TickScope(const TickScope&) = delete;
+			TickScope(TickScope&&) = delete;
+
+			TickScope& operator=(const TickScope&) = delete;
+			TickScope& operator=(TickScope&&) = delete;
+
+		private:
+			std::chrono::steady_clock::time_point _start{};
+		};
+
+		enum class Kind : std::uint8_t
+		{
+			kCrosshair,
+			kLockChanged,
+			kCombat,
+			kContainerDelta,
+			kMenuOpenClose,
+			kButton,
+
+			kTotal
+		};
+
+		[[nodiscard]] static bool Recording() noexcept
+		{
+#ifndef NDEBUG
+			return _recording.load(std::memory_order_relaxed);
+#else
+			return false;
+#endif
+		}
+
+		static void RecordCrosshair(RE::TESObjectREFR* a_ref)
+		{
+			if (Recording()) {
+				WriteCrosshair(a_ref);
+			}
+		}
+
+		static void RecordLockChanged(const RE::TESObjectREFR& a_ref)
+		{
+			if (Recording()) {
+				WriteLockChanged(a_ref);
+			}
+		}
+
+		static void RecordCombat(const RE::TESCombatEvent& a_event)
+		{
+			if (Recording()) {
+				WriteCombat(a_event);
+			}
+		}
+
+		static void RecordContainerDelta(const InventoryDelta& a_delta)
+		{
+			if (Recording()) {
+				WriteContainerDelta(a_delta);
+			}
+		}
+
+		static void RecordMenuOpenClose(const RE::MenuOpenCloseEvent& a_event)
+		{
+			if (Recording()) {
+				WriteMenuOpenClose(a_event);
+			}
+		}
+
+		static void RecordInput(const RE::InputEvent* a_event)
+		{
+			if (Recording()) {
+				WriteInput(a_event);
+			}
+		}
+
+		[[nodiscard]] static bool Replaying() noexcept
+		{
+#ifndef NDEBUG
+			return _replaying.load(std::memory_order_relaxed);
+#else
+			return false;
+#endif
+		}
+
+		// Nothing ticks while the menu is closed, the replay moves on without it
+		static void MenuClosed()
+		{
+			if (Replaying()) {
+				QueueClosedFeed();
+			}
+		}
+
+		// Starts a recording, or stops the current one and writes it out
+		static void ToggleRecording();
+
+		// Feeds the last written trace back in, one event per menu tick, and logs the time each event
+		// took. Stops the replay when one is running. Takes it drives remove nothing, the recorded
+		// container changes stand in for them
+		static void Replay();
+
+	private:
+		static void WriteCrosshair(RE::TESObjectREFR* a_ref);
+		static void WriteLockChanged(const RE::TESObjectREFR& a_ref);
+		static void WriteCombat(const RE::TESCombatEvent& a_event);
+		static void WriteContainerDelta(const InventoryDelta& a_delta);
+		static void WriteMenuOpenClose(const RE::MenuOpenCloseEvent& a_event);
+		static void WriteInput(const RE::InputEvent* a_event);
+
+		static void BeginTick();
+		static void EndTick(std::chrono::steady_clock::duration a_elapsed);
+		static void QueueClosedFeed();
+		static void FeedClosed();
+		static void EndReplay();
+
+		[[nodiscard]] static std::optional<std::filesystem::path> Path();
+
+		static inline std::atomic_bool _recording{ false };
+		static inline std::atomic_bool _replaying{ false };
+	};
+}
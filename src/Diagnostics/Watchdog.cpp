@@ -0,0 +1,100 @@
+#include "Diagnostics/Watchdog.h"
+
+namespace Diagnostics
+{
+	namespace
+	{
+		thread_local Watchdog::Scope* current{ nullptr };
+	}
+
+	Watchdog::Scope::Scope(std::string_view a_stage) noexcept :
+		_stage(a_stage),
+		_parent(current),
+		_start(),
+		_armed(Settings::HitchThresholdMs() > 0.0F)
+	{
+		if (_armed) {
+			_start = std::chrono::steady_clock::now();
+		}
+		current = this;
+	}
+
+	Watchdog::Scope::~Scope()
+	{
+		current = _parent;
+		if (!_armed) {
+			return;
+		}
+
+		const auto ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - _start).count();
+		const auto threshold = Settings::HitchThresholdMs();
+		if (ms < threshold) {
+			return;
+		}
+
+		if (_parent) {
+			_parent->_childMs += ms;
+		}
+
+		// A slow child was already recorded, the parent only counts for what it spent itself
+		if (ms - _childMs < threshold) {
+			return;
+		}
+
+		GetSingleton().Record(_stage, _parent ? _parent->_stage : ""sv, ms);
+	}
+
+	void Watchdog::Dump()
+	{
+		auto& self = GetSingleton();
+		std::scoped_lock l{ self._lock };
+
+		const auto count = std::min(self._written, RING_SIZE);
+		logger::info("{} hitches recorded, showing the last {}"sv, self._written, count);
+
+		for (std::size_t i = self._written - count; i < self._written; ++i) {
+			const auto& hitch = self._ring[i % RING_SIZE];
+
+			std::string tasks;
+			for (const auto task : hitch.tasks) {
+				if (task) {
+					if (!tasks.empty()) {
+						tasks += ", "sv;
+					}
+					tasks += task;
+				}
+			}
+
+			logger::info(
+				"{:.2f} ms in {}{}{} | container {:08X} | {} rows | last tasks: {}"sv,
+				hitch.ms,
+				hitch.stage,
+				hitch.parent.empty() ? ""sv : " under "sv,
+				hitch.parent,
+				hitch.container,
+				hitch.rows,
+				tasks.empty() ? "none"sv : tasks);
+		}
+	}
+
+	void Watchdog::Record(std::string_view a_stage, std::string_view a_parent, float a_ms)
+	{
+		Hitch hitch{
+			a_stage,
+			a_parent,
+			a_ms,
+			_container.load(std::memory_order_relaxed),
+			_rows.load(std::memory_order_relaxed),
+			{}
+		};
+
+		// Newest first
+		const auto cursor = _taskCursor.load(std::memory_order_relaxed);
+		for (std::size_t i = 0; i < TASK_HISTORY; ++i) {
+			hitch.tasks[i] = _tasks[(cursor - 1 - i) % TASK_HISTORY].load(std::memory_order_relaxed);
+		}
+
+		std::scoped_lock l{ _lock };
+		_ring[_written++ % RING_SIZE] = hitch;
+	}
+}
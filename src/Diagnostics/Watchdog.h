@@ -0,0 +1,93 @@
+#pragma once
+
+namespace Diagnostics
+{
+	// Times the menu's tick, the task queue and every event sink. A stage that runs past the hitch
+	// threshold is kept in a small ring with the container, the row count and the tasks queued last,
+	// the ring is only written to the log when asked for.
+	class Watchdog
+	{
+	public:
+		static constexpr std::size_t RING_SIZE{ 32 };
+		static constexpr std::size_t TASK_HISTORY{ 4 };
+
+		// Times the enclosing block. A slow nested scope takes the blame, its parent is only recorded
+		// when it was slow on its own as well
+		class Scope
+		{
+		public:
+			explicit Scope(std::string_view a_stage) noexcept;
+			~Scope();
+
+			Scope(const Scope&) = delete;
+			Scope(Scope&&) = delete;
+
+			Scope& operator=(const Scope&) = delete;
+			Scope& operator=(Scope&&) = delete;
+
+		private:
+			std::string_view _stage;
+			Scope* _parent;
+			std::chrono::steady_clock::time_point _start;
+			bool _armed;
+			float _childMs{ 0.0F };  // spent in nested scopes that were recorded
+		};
+
+		static void SetContainer(RE::FormID a_formID) noexcept
+		{
+			GetSingleton()._container.store(a_formID, std::memory_order_relaxed);
+		}
+
+		static void SetRows(std::size_t a_rows) noexcept
+		{
+			GetSingleton()._rows.store(static_cast<std::uint32_t>(a_rows), std::memory_order_relaxed);
+		}
+
+		// Remembers where a task was queued from, the name must have static storage
+		static void NoteTask(const char* a_where) noexcept
+		{
+			auto& self = GetSingleton();
+			const auto idx = self._taskCursor.fetch_add(1, std::memory_order_relaxed);
+			self._tasks[idx % TASK_HISTORY].store(a_where, std::memory_order_relaxed);
+		}
+
+		// Writes the recorded hitches to the log, oldest first
+		static void Dump();
+
+	private:
+		struct Hitch
+		{
+			std::string_view stage;
+			std::string_view parent;
+			float ms;
+			RE::FormID container;
+			std::uint32_t rows;
+			std::array<const char*, TASK_HISTORY> tasks;
+		};
+
+		Watchdog() = default;
+		Watchdog(const Watchdog&) = delete;
+		Watchdog(Watchdog&&) = delete;
+
+		~Watchdog() = default;
+
+		Watchdog& operator=(const Watchdog&) = delete;
+		Watchdog& operator=(Watchdog&&) = delete;
+
+		[[nodiscard]] static Watchdog& GetSingleton()
+		{
+			static Watchdog singleton;
+			return singleton;
+		}
+
+		void Record(std::string_view a_stage, std::string_view a_parent, float a_ms);
+
+		std::mutex _lock;  // taken on the hitch path and by Dump only
+		std::array<Hitch, RING_SIZE> _ring{};
+		std::size_t _written{ 0 };
+		std::atomic<RE::FormID> _container{ 0 };
+		std::atomic_uint32_t _rows{ 0 };
+		std::array<std::atomic<const char*>, TASK_HISTORY> _tasks{};
+		std::atomic_size_t _taskCursor{ 0 };
+	};
+}
@@ -64,6 +64,12 @@ namespace Events
 		loot.Close();
 	}
 
+	void ContainerValidityManager::Revalidate(RE::FormID a_ref)
+	{
+		auto& loot = Loot::GetSingleton();
+		loot.Revalidate(a_ref);
+	}
+
 	void LifeStateManager::Register()
 	{
 		if (REL::Module::IsAE()) {
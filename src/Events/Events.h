@@ -4,6 +4,12 @@
 #undef GetObject
 #endif
 
+#include "Area/LootableGrid.h"
+#include "Diagnostics/EventTrace.h"
+#include "Diagnostics/Watchdog.h"
+#include "Items/AcquisitionLog.h"
+#include "Items/OwnershipCache.h"
+
 namespace Events
 {
 	class CrosshairRefManager :
@@ -40,6 +46,8 @@ namespace Events
 
 		EventResult ProcessEvent(const SKSE::CrosshairRefEvent* a_event, RE::BSTEventSource<SKSE::CrosshairRefEvent>*) override
 		{
+			Diagnostics::Watchdog::Scope watch{ "CrosshairRefManager::CrosshairRefEvent"sv };
+
 			auto crosshairRef =
 				a_event && a_event->crosshairRef ?
                     a_event->crosshairRef->CreateRefHandle() :
@@ -50,6 +58,7 @@ namespace Events
 
 			_cachedRef = crosshairRef;
 			_cachedAshPile.reset();
+			Diagnostics::EventTrace::RecordCrosshair(a_event ? a_event->crosshairRef.get() : nullptr);
 			Evaluate(a_event->crosshairRef);
 
 			return EventResult::kContinue;
@@ -57,9 +66,12 @@ namespace Events
 
 		EventResult ProcessEvent(const RE::TESLockChangedEvent* a_event, RE::BSTEventSource<RE::TESLockChangedEvent>*) override
 		{
+			Diagnostics::Watchdog::Scope watch{ "CrosshairRefManager::TESLockChangedEvent"sv };
+
 			if (a_event &&
 				a_event->lockedObject &&
 				a_event->lockedObject->GetHandle() == _cachedRef) {
+				Diagnostics::EventTrace::RecordLockChanged(*a_event->lockedObject);
 				Evaluate(a_event->lockedObject);
 			}
 
@@ -104,21 +116,7 @@ namespace Events
 				return CanOpen(_cachedAshPile.get());
 			}
 
-			//const bool disable_for_animals = Settings::DisableForAnimals();
-
-			if (auto actor = a_ref->As<RE::Actor>(); actor) {
-				//auto dobj = RE::BGSDefaultObjectManager::GetSingleton();
-				//auto animal_keyword = dobj->GetObject<RE::BGSKeyword>(RE::DEFAULT_OBJECT::kKeywordAnimal);
-
-				if (!actor->IsDead() 
-					|| actor->IsSummoned())
-					//|| (disable_for_animals && actor->GetRace()->HasKeyword(animal_keyword)))
-				{
-					return false;
-				}
-			}
-
-			return a_ref->HasContainer();
+			return Area::LootableGrid::IsLootable(*a_ref);
 		}
 
 		RE::ObjectRefHandle _cachedRef;
@@ -149,6 +147,8 @@ namespace Events
 
 		EventResult ProcessEvent(const RE::TESCombatEvent* a_event, RE::BSTEventSource<RE::TESCombatEvent>*) override
 		{
+			Diagnostics::Watchdog::Scope watch{ "CombatManager::TESCombatEvent"sv };
+
 			if (!Settings::CloseInCombat())
 				return EventResult::kContinue;
 
@@ -159,6 +159,7 @@ namespace Events
 			};
 
 			if (a_event && (isPlayerRef(a_event->actor) || isPlayerRef(a_event->targetActor))) {
+				Diagnostics::EventTrace::RecordCombat(*a_event);
 				switch (*a_event->newState) {
 				case CombatState::kCombat:
 				case CombatState::kSearching:
@@ -210,6 +211,8 @@ namespace Events
 
 		EventResult ProcessEvent(const RE::TESLockChangedEvent* a_event, RE::BSTEventSource<RE::TESLockChangedEvent>*) override
 		{
+			Diagnostics::Watchdog::Scope watch{ "LockedContainerManager::TESLockChangedEvent"sv };
+
 			if (!Settings::OpenWhenContainerUnlocked())
 				return EventResult::kContinue;
 
@@ -237,6 +240,88 @@ namespace Events
 		void Close();
 	};
 
+	// Forwards the events that can invalidate the displayed container, the menu checks it only then
+	class ContainerValidityManager :
+		public RE::BSTEventSink<RE::TESCellAttachDetachEvent>,
+		public RE::BSTEventSink<RE::TESFormDeleteEvent>,
+		public RE::BSTEventSink<RE::TESMoveAttachDetachEvent>,
+		public RE::BSTEventSink<RE::TESObjectLoadedEvent>
+	{
+	public:
+		static ContainerValidityManager* GetSingleton()
+		{
+			static ContainerValidityManager singleton;
+			return std::addressof(singleton);
+		}
+
+		static void Register()
+		{
+			auto scripts = RE::ScriptEventSourceHolder::GetSingleton();
+			if (scripts) {
+				scripts->AddEventSink<RE::TESCellAttachDetachEvent>(GetSingleton());
+				scripts->AddEventSink<RE::TESFormDeleteEvent>(GetSingleton());
+				scripts->AddEventSink<RE::TESMoveAttachDetachEvent>(GetSingleton());
+				scripts->AddEventSink<RE::TESObjectLoadedEvent>(GetSingleton());
+				logger::info("Registered {}"sv, typeid(ContainerValidityManager).name());
+			}
+		}
+
+	protected:
+		using EventResult = RE::BSEventNotifyControl;
+
+		EventResult ProcessEvent(const RE::TESCellAttachDetachEvent* a_event, RE::BSTEventSource<RE::TESCellAttachDetachEvent>*) override
+		{
+			Diagnostics::Watchdog::Scope watch{ "ContainerValidityManager::TESCellAttachDetachEvent"sv };
+
+			if (a_event && a_event->reference) {
+				Revalidate(a_event->reference->GetFormID());
+			}
+			return EventResult::kContinue;
+		}
+
+		EventResult ProcessEvent(const RE::TESFormDeleteEvent* a_event, RE::BSTEventSource<RE::TESFormDeleteEvent>*) override
+		{
+			Diagnostics::Watchdog::Scope watch{ "ContainerValidityManager::TESFormDeleteEvent"sv };
+
+			if (a_event) {
+				Revalidate(a_event->formID);
+			}
+			return EventResult::kContinue;
+		}
+
+		EventResult ProcessEvent(const RE::TESMoveAttachDetachEvent* a_event, RE::BSTEventSource<RE::TESMoveAttachDetachEvent>*) override
+		{
+			Diagnostics::Watchdog::Scope watch{ "ContainerValidityManager::TESMoveAttachDetachEvent"sv };
+
+			if (a_event && a_event->movedRef) {
+				Revalidate(a_event->movedRef->GetFormID());
+			}
+			return EventResult::kContinue;
+		}
+
+		EventResult ProcessEvent(const RE::TESObjectLoadedEvent* a_event, RE::BSTEventSource<RE::TESObjectLoadedEvent>*) override
+		{
+			Diagnostics::Watchdog::Scope watch{ "ContainerValidityManager::TESObjectLoadedEvent"sv };
+
+			if (a_event) {
+				Revalidate(a_event->formID);
+			}
+			return EventResult::kContinue;
+		}
+
+	private:
+		ContainerValidityManager() = default;
+		ContainerValidityManager(const ContainerValidityManager&) = delete;
+		ContainerValidityManager(ContainerValidityManager&&) = delete;
+
+		~ContainerValidityManager() = default;
+
+		ContainerValidityManager& operator=(const ContainerValidityManager&) = delete;
+		ContainerValidityManager& operator=(ContainerValidityManager&&) = delete;
+
+		void Revalidate(RE::FormID a_ref);
+	};
+
 	class LifeStateManager
 	{
 	public:
@@ -245,6 +330,10 @@ namespace Events
 	private:
 		static void OnLifeStateChanged(RE::Actor* a_actor)
 		{
+			Diagnostics::Watchdog::Scope watch{ "LifeStateManager::OnLifeStateChanged"sv };
+
+			Area::LootableGrid::GetSingleton()->OnLifeStateChanged(*a_actor);
+
 			const auto manager = CrosshairRefManager::GetSingleton();
 			manager->OnLifeStateChanged(*a_actor);
 		}
@@ -256,6 +345,10 @@ namespace Events
 		LifeStateManager::Register();
 		LockedContainerManager::Register();
 		CombatManager::Register();
+		ContainerValidityManager::Register();
+		Items::AcquisitionLog::Register();
+		Items::OwnershipCache::Register();
+		Area::LootableGrid::Register();
 
 		logger::info("Registered all event handlers"sv);
 	}
@@ -0,0 +1,21 @@
+#pragma once
+
+// The menu's refs, resolved once per tick. Every ObjectRefHandle::get goes through the engine's
+// handle table and its lock, so the stages of a tick share these instead of resolving again.
+struct FrameContext
+{
+	[[nodiscard]] static FrameContext Resolve(RE::ObjectRefHandle a_src, RE::ActorHandle a_dst)
+	{
+		return { a_src, a_src.get(), a_dst.get() };
+	}
+
+	// Reuses the resolved source when the handle refers to it
+	[[nodiscard]] RE::TESObjectREFRPtr Container(RE::ObjectRefHandle a_handle) const
+	{
+		return a_handle == srcHandle ? src : a_handle.get();
+	}
+
+	RE::ObjectRefHandle srcHandle;
+	RE::TESObjectREFRPtr src;
+	RE::ActorPtr dst;
+};
@@ -83,6 +83,7 @@ namespace Input
 				_mappings{}
 			{
 				insert("Activate"sv);
+				insert("Toggle POV"sv);
 				insert("Ready Weapon"sv);
 			}
 
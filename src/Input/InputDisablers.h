@@ -32,4 +32,63 @@ namespace Input
 			}
 		}
 	};
+
+	// Lets the game send text input and blocks the gameplay controls typed text would otherwise
+	// trigger. Only the controls that were enabled beforehand are enabled again, whatever a scene,
+	// script or mod disabled meanwhile stays as it was.
+	class TextEntryDisablers
+	{
+	public:
+		TextEntryDisablers() = default;
+		TextEntryDisablers(const TextEntryDisablers&) = delete;
+		TextEntryDisablers(TextEntryDisablers&&) = delete;
+
+		~TextEntryDisablers() { Disable(); }
+
+		TextEntryDisablers& operator=(const TextEntryDisablers&) = delete;
+		TextEntryDisablers& operator=(TextEntryDisablers&&) = delete;
+
+		void Enable() { Toggle(true); }
+		void Disable() { Toggle(false); }
+
+	private:
+		using UEFlag = RE::UserEvents::USER_EVENT_FLAG;
+
+		static constexpr auto FLAGS = static_cast<UEFlag>(
+			stl::to_underlying(UEFlag::kMovement) |
+			stl::to_underlying(UEFlag::kLooking) |
+			stl::to_underlying(UEFlag::kActivate) |
+			stl::to_underlying(UEFlag::kMenu) |
+			stl::to_underlying(UEFlag::kPOVSwitch) |
+			stl::to_underlying(UEFlag::kFighting) |
+			stl::to_underlying(UEFlag::kSneaking) |
+			stl::to_underlying(UEFlag::kMainFour) |
+			stl::to_underlying(UEFlag::kWheelZoom) |
+			stl::to_underlying(UEFlag::kJumping));
+
+		void Toggle(bool a_enable)
+		{
+			auto controlMap = RE::ControlMap::GetSingleton();
+			if (!controlMap || _enabled == a_enable) {
+				return;
+			}
+
+			if (a_enable) {
+				_restore = static_cast<UEFlag>(
+					stl::to_underlying(controlMap->enabledControls.get()) &
+					stl::to_underlying(FLAGS));
+				controlMap->ToggleControls(FLAGS, false);
+				controlMap->AllowTextInput(true);
+			} else {
+				controlMap->AllowTextInput(false);
+				if (_restore != UEFlag::kNone) {
+					controlMap->ToggleControls(_restore, true);
+				}
+			}
+			_enabled = a_enable;
+		}
+
+		UEFlag _restore{ UEFlag::kNone };  // the FLAGS that were enabled before the search
+		bool _enabled{ false };
+	};
 }
@@ -71,6 +71,28 @@ namespace Input
 		loot.Close();
 	}
 
+	void TakeAllHandler::DoHandle(RE::InputEvent* const& a_event)
+	{
+		for (auto iter = a_event; iter; iter = iter->next) {
+			auto event = iter->AsButtonEvent();
+			if (!event) {
+				continue;
+			}
+
+			auto controlMap = RE::ControlMap::GetSingleton();
+			const auto idCode =
+				controlMap ?
+                    controlMap->GetMappedKey("Toggle POV"sv, event->GetDevice()) :
+                    RE::ControlMap::kInvalid;
+
+			if (event->GetIDCode() == idCode && event->IsDown()) {
+				auto& loot = Loot::GetSingleton();
+				loot.TakeAll();
+				return;
+			}
+		}
+	}
+
 	void TransferHandler::DoHandle(RE::InputEvent* const& a_event)
 	{
 		for (auto iter = a_event; iter; iter = iter->next) {
@@ -97,4 +119,72 @@ namespace Input
 			}
 		}
 	}
+
+	void SortModeHandler::DoHandle(RE::InputEvent* const& a_event)
+	{
+		const auto key = Settings::SortModeKey();
+		if (key <= 0) {
+			return;
+		}
+
+		for (auto iter = a_event; iter; iter = iter->next) {
+			auto event = iter->AsButtonEvent();
+			if (event &&
+				event->GetDevice() == RE::INPUT_DEVICE::kKeyboard &&
+				event->GetIDCode() == static_cast<std::uint32_t>(key) &&
+				event->IsDown()) {
+				auto& loot = Loot::GetSingleton();
+				loot.CycleSortMode();
+				return;
+			}
+		}
+	}
+
+	void SearchHandler::DoHandle(RE::InputEvent* const& a_event)
+	{
+		using Keyboard = RE::BSWin32KeyboardDevice::Key;
+
+		auto& loot = Loot::GetSingleton();
+		const auto key = Settings::SearchKey();
+		for (auto iter = a_event; iter; iter = iter->next) {
+			if (!loot.IsSearching()) {
+				const auto event = iter->AsButtonEvent();
+				if (key > 0 &&
+					event &&
+					event->GetDevice() == RE::INPUT_DEVICE::kKeyboard &&
+					event->GetIDCode() == static_cast<std::uint32_t>(key) &&
+					event->IsDown()) {
+					loot.ToggleSearch();
+					return;  // the key's own character follows in this chain
+				}
+				continue;
+			}
+
+			if (iter->GetEventType() == RE::INPUT_EVENT_TYPE::kChar) {
+				const auto event = static_cast<const RE::CharEvent*>(iter);
+				if (event->keycode >= 0x20 && event->keycode != 0x7F) {
+					loot.AppendSearch(static_cast<char32_t>(event->keycode));
+				}
+				continue;
+			}
+
+			const auto event = iter->AsButtonEvent();
+			if (!event || event->GetDevice() != RE::INPUT_DEVICE::kKeyboard || !event->IsDown()) {
+				continue;
+			}
+
+			const auto idCode = event->GetIDCode();
+			if (idCode == Keyboard::kBackspace) {
+				loot.PopSearch();
+			} else if (idCode == Keyboard::kEnter || idCode == Keyboard::kEscape || idCode == static_cast<std::uint32_t>(key)) {
+				loot.ToggleSearch();
+				return;
+			}
+		}
+	}
+
+	bool Listeners::IsSearching()
+	{
+		return Loot::GetSingleton().IsSearching();
+	}
 }
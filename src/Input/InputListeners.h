@@ -1,5 +1,8 @@
 #pragma once
 
+#include "Diagnostics/EventTrace.h"
+#include "Diagnostics/Watchdog.h"
+
 namespace Input
 {
 	class IHandler
@@ -9,6 +12,9 @@ namespace Input
 
 		void operator()(RE::InputEvent* const& a_event) { DoHandle(a_event); }
 
+		// Handlers that don't opt in are muted while the search has the keyboard
+		[[nodiscard]] virtual bool ActiveWhileSearching() const noexcept { return false; }
+
 	protected:
 		virtual void DoHandle(RE::InputEvent* const& a_event) = 0;
 	};
@@ -19,6 +25,8 @@ namespace Input
 	public:
 		ScrollHandler();
 
+		[[nodiscard]] bool ActiveWhileSearching() const noexcept override { return true; }
+
 	protected:
 		void DoHandle(RE::InputEvent* const& a_event) override
 		{
@@ -160,6 +168,13 @@ namespace Input
 		bool _context{ false };
 	};
 
+	class TakeAllHandler :
+		public IHandler
+	{
+	protected:
+		void DoHandle(RE::InputEvent* const& a_event) override;
+	};
+
 	class TransferHandler :
 		public IHandler
 	{
@@ -167,15 +182,35 @@ namespace Input
 		void DoHandle(RE::InputEvent* const& a_event) override;
 	};
 
+	class SortModeHandler :
+		public IHandler
+	{
+	protected:
+		void DoHandle(RE::InputEvent* const& a_event) override;
+	};
+
+	class SearchHandler :
+		public IHandler
+	{
+	public:
+		[[nodiscard]] bool ActiveWhileSearching() const noexcept override { return true; }
+
+	protected:
+		void DoHandle(RE::InputEvent* const& a_event) override;
+	};
+
 	class Listeners :
 		public RE::BSTEventSink<RE::InputEvent*>
 	{
 	public:
 		Listeners()
 		{
+			_callbacks.push_back(std::make_unique<SearchHandler>());
 			_callbacks.push_back(std::make_unique<TakeHandler>());
+			_callbacks.push_back(std::make_unique<TakeAllHandler>());
 			_callbacks.push_back(std::make_unique<ScrollHandler>());
 			_callbacks.push_back(std::make_unique<TransferHandler>());
+			_callbacks.push_back(std::make_unique<SortModeHandler>());
 		}
 
 		Listeners(const Listeners&) = default;
@@ -207,15 +242,22 @@ namespace Input
 
 		EventResult ProcessEvent(RE::InputEvent* const* a_event, RE::BSTEventSource<RE::InputEvent*>*) override
 		{
+			Diagnostics::Watchdog::Scope watch{ "Listeners::InputEvent"sv };
+
 			if (a_event) {
+				Diagnostics::EventTrace::RecordInput(*a_event);
 				for (auto& callback : _callbacks) {
-					(*callback)(*a_event);
+					if (!IsSearching() || callback->ActiveWhileSearching()) {
+						(*callback)(*a_event);
+					}
 				}
 			}
 
 			return EventResult::kContinue;
 		}
 
+		[[nodiscard]] static bool IsSearching();
+
 		std::vector<std::unique_ptr<IHandler>> _callbacks{};
 	};
 }
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Diagnostics/Watchdog.h"
+
+namespace Items
+{
+	// Remembers when objects last entered each container, which backs the "recently acquired" sort.
+	// Bounded: once full, the older half of the stamps is forgotten.
+	class AcquisitionLog :
+		public RE::BSTEventSink<RE::TESContainerChangedEvent>
+	{
+	public:
+		[[nodiscard]] static AcquisitionLog* GetSingleton()
+		{
+			static AcquisitionLog singleton;
+			return std::addressof(singleton);
+		}
+
+		static void Register()
+		{
+			auto scripts = RE::ScriptEventSourceHolder::GetSingleton();
+			if (scripts) {
+				scripts->AddEventSink<RE::TESContainerChangedEvent>(GetSingleton());
+				logger::info("Registered {}"sv, typeid(AcquisitionLog).name());
+			}
+		}
+
+		// Higher is more recent, 0 when the object was never seen entering the container
+		[[nodiscard]] std::uint32_t Stamp(RE::FormID a_container, RE::FormID a_object) const
+		{
+			std::scoped_lock l{ _lock };
+			const auto it = _stamps.find(Key(a_container, a_object));
+			return it != _stamps.end() ? it->second : 0;
+		}
+
+	protected:
+		using EventResult = RE::BSEventNotifyControl;
+
+		EventResult ProcessEvent(const RE::TESContainerChangedEvent* a_event, RE::BSTEventSource<RE::TESContainerChangedEvent>*) override
+		{
+			Diagnostics::Watchdog::Scope watch{ "AcquisitionLog::TESContainerChangedEvent"sv };
+
+			if (a_event && a_event->newContainer != 0 && a_event->baseObj != 0) {
+				std::scoped_lock l{ _lock };
+				_stamps.insert_or_assign(Key(a_event->newContainer, a_event->baseObj), ++_clock);
+				if (_stamps.size() > MAX_STAMPS) {
+					const auto cutoff = _clock - MAX_STAMPS / 2;
+					std::erase_if(_stamps, [&](auto&& a_elem) { return a_elem.second <= cutoff; });
+				}
+			}
+
+			return EventResult::kContinue;
+		}
+
+	private:
+		static constexpr std::uint32_t MAX_STAMPS{ 1 << 12 };
+
+		AcquisitionLog() = default;
+		AcquisitionLog(const AcquisitionLog&) = delete;
+		AcquisitionLog(AcquisitionLog&&) = delete;
+
+		~AcquisitionLog() = default;
+
+		AcquisitionLog& operator=(const AcquisitionLog&) = delete;
+		AcquisitionLog& operator=(AcquisitionLog&&) = delete;
+
+		[[nodiscard]] static std::uint64_t Key(RE::FormID a_container, RE::FormID a_object) noexcept
+		{
+			return (static_cast<std::uint64_t>(a_container) << 32) | a_object;
+		}
+
+		mutable std::mutex _lock;
+		std::unordered_map<std::uint64_t, std::uint32_t> _stamps;
+		std::uint32_t _clock{ 0 };
+	};
+}
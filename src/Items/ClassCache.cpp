@@ -0,0 +1,267 @@
+#include "Items/ClassCache.h"
+
+#include "Diagnostics/Watchdog.h"
+#include "Items/DisplayFilter.h"
+#include "Items/GFxItem.h"
+
+#include <fstream>
+
+#include <Windows.h>
+
+#undef GetObject
+
+namespace Items
+{
+	// A read-only mapping of the whole file
+	class ClassCache::View
+	{
+	public:
+		View() = delete;
+		View(const View&) = delete;
+		View(View&&) = delete;
+
+		~View()
+		{
+			if (_base) {
+				::UnmapViewOfFile(_base);
+			}
+			if (_mapping) {
+				::CloseHandle(_mapping);
+			}
+			if (_file != INVALID_HANDLE_VALUE) {
+				::CloseHandle(_file);
+			}
+		}
+
+		View& operator=(const View&) = delete;
+		View& operator=(View&&) = delete;
+
+		// nullptr when the file is missing, truncated or was written for another load order
+		[[nodiscard]] static std::unique_ptr<View> Open(const std::filesystem::path& a_path, std::uint64_t a_loadOrder)
+		{
+			auto view = std::unique_ptr<View>{ new View(a_path) };
+			if (!view->_base) {
+				return nullptr;
+			}
+
+			LARGE_INTEGER size{};
+			if (!::GetFileSizeEx(view->_file, std::addressof(size)) || static_cast<std::uint64_t>(size.QuadPart) < sizeof(Header)) {
+				return nullptr;
+			}
+
+			const auto header = static_cast<const Header*>(view->_base);
+			const auto available = (static_cast<std::uint64_t>(size.QuadPart) - sizeof(Header)) / sizeof(Record);
+			if (header->magic != MAGIC || header->format != FORMAT || header->loadOrder != a_loadOrder || header->count > available) {
+				return nullptr;
+			}
+
+			const auto records = reinterpret_cast<const Record*>(header + 1);
+			view->_records = { records, static_cast<std::size_t>(header->count) };
+			return view;
+		}
+
+		[[nodiscard]] const Record* Find(RE::FormID a_formID) const noexcept
+		{
+			const auto it = std::lower_bound(_records.begin(), _records.end(), a_formID, [](const Record& a_record, RE::FormID a_id) {
+				return a_record.formID < a_id;
+			});
+			return it != _records.end() && it->formID == a_formID ? std::addressof(*it) : nullptr;
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept { return _records.size(); }
+
+	private:
+		explicit View(const std::filesystem::path& a_path)
+		{
+			_file = ::CreateFileW(a_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (_file == INVALID_HANDLE_VALUE) {
+				return;
+			}
+
+			_mapping = ::CreateFileMappingW(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (_mapping) {
+				_base = ::MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+			}
+		}
+
+		HANDLE _file{ INVALID_HANDLE_VALUE };
+		HANDLE _mapping{ nullptr };
+		const void* _base{ nullptr };
+		std::span<const Record> _records;
+	};
+
+	void ClassCache::Init()
+	{
+		auto cache = GetSingleton();
+		cache->_loadOrder = HashLoadOrder();
+
+		const auto path = Path();
+		if (auto view = View::Open(path, cache->_loadOrder); view) {
+			logger::info("Classification cache holds {} forms"sv, view->size());
+			cache->_view.store(view.release(), std::memory_order_release);
+			cache->_enabled.store(true, std::memory_order_relaxed);
+		} else if (std::error_code ec; std::filesystem::exists(path, ec)) {
+			// The file only exists if the cache was turned on, it is rebuilt once a game loads
+			logger::info("Classification cache is stale"sv);
+		}
+
+		auto scripts = RE::ScriptEventSourceHolder::GetSingleton();
+		if (scripts) {
+			scripts->AddEventSink<RE::TESLoadGameEvent>(cache);
+		}
+	}
+
+	auto ClassCache::Find(RE::FormID a_formID) noexcept
+		-> const Record*
+	{
+		const auto cache = GetSingleton();
+		if (!cache->_enabled.load(std::memory_order_relaxed)) {
+			return nullptr;
+		}
+
+		const auto view = cache->_view.load(std::memory_order_acquire);
+		return view ? view->Find(a_formID) : nullptr;
+	}
+
+	auto ClassCache::ProcessEvent(const RE::TESLoadGameEvent*, RE::BSTEventSource<RE::TESLoadGameEvent>*)
+		-> EventResult
+	{
+		Diagnostics::Watchdog::Scope watch{ "ClassCache::TESLoadGameEvent"sv };
+
+		const auto enabled = Settings::CacheClassification();
+		_enabled.store(enabled, std::memory_order_relaxed);
+		if (enabled && !_view.load(std::memory_order_acquire)) {
+			Rebuild();
+		}
+		return EventResult::kContinue;
+	}
+
+	// Plugin names in load order with the size and write time of each file, so an updated plugin
+	// invalidates the cache as well as a changed load order
+	std::uint64_t ClassCache::HashLoadOrder()
+	{
+		std::uint64_t hash = 14695981039346656037ull;
+		const auto mix = [&](const void* a_data, std::size_t a_size) {
+			const auto bytes = static_cast<const std::uint8_t*>(a_data);
+			for (std::size_t i = 0; i < a_size; ++i) {
+				hash = (hash ^ bytes[i]) * 1099511628211ull;
+			}
+		};
+
+		const auto version = Plugin::VERSION.pack();
+		mix(std::addressof(version), sizeof(version));
+		mix(std::addressof(FORMAT), sizeof(FORMAT));
+
+		const auto dataHandler = RE::TESDataHandler::GetSingleton();
+		if (!dataHandler) {
+			return hash;
+		}
+
+		const auto mixFile = [&](const RE::TESFile* a_file) {
+			if (!a_file) {
+				return;
+			}
+
+			const auto name = a_file->GetFilename();
+			mix(name.data(), name.size());
+
+			std::error_code ec;
+			const auto path = std::filesystem::path{ "Data"sv } / name;
+			const auto size = std::filesystem::file_size(path, ec);
+			const auto time = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+			mix(std::addressof(size), sizeof(size));
+			mix(std::addressof(time), sizeof(time));
+		};
+
+		for (const auto file : dataHandler->compiledFileCollection.files) {
+			mixFile(file);
+		}
+		for (const auto file : dataHandler->compiledFileCollection.smallFiles) {
+			mixFile(file);
+		}
+		return hash;
+	}
+
+	std::filesystem::path ClassCache::Path()
+	{
+		return std::filesystem::path{ "Data/SKSE/Plugins"sv } / fmt::format("{}.classcache"sv, Plugin::NAME);
+	}
+
+	// Forms are classified here, on the main thread, only writing the file happens in the background
+	void ClassCache::Rebuild()
+	{
+		static constexpr std::array types{
+			RE::FormType::Scroll,
+			RE::FormType::Armor,
+			RE::FormType::Book,
+			RE::FormType::Ingredient,
+			RE::FormType::Light,
+			RE::FormType::Misc,
+			RE::FormType::Weapon,
+			RE::FormType::Ammo,
+			RE::FormType::KeyMaster,
+			RE::FormType::AlchemyItem,
+			RE::FormType::Note,
+			RE::FormType::SoulGem,
+		};
+
+		const auto dataHandler = RE::TESDataHandler::GetSingleton();
+		if (!dataHandler || _building.exchange(true)) {
+			return;
+		}
+
+		std::vector<Record> records;
+		for (const auto type : types) {
+			// Armor, book and misc types are told apart by vendor keywords
+			const bool typed = type != RE::FormType::Armor && type != RE::FormType::Book && type != RE::FormType::Misc;
+			for (const auto form : dataHandler->GetFormArray(type)) {
+				if (!form || (form->GetFormID() >> 24) == 0xFF) {
+					continue;
+				}
+
+				Record record{ form->GetFormID(), 0, 0, 0 };
+				if (const auto object = form->As<RE::TESBoundObject>(); object && DisplayFilter::Evaluate(*object)) {
+					record.flags |= kDisplayable;
+				}
+				if (typed) {
+					record.type = static_cast<std::uint8_t>(GFxItem::ComputeItemType(form));
+					record.flags |= kTyped;
+				}
+				records.push_back(record);
+			}
+		}
+
+		std::sort(records.begin(), records.end(), [](const Record& a_lhs, const Record& a_rhs) {
+			return a_lhs.formID < a_rhs.formID;
+		});
+
+		std::thread([this, records = std::move(records)]() {
+			// Written aside and swapped in, a crash mid-write leaves no torn file behind
+			const auto path = Path();
+			auto temp = path;
+			temp += ".tmp"sv;
+
+			const Header header{ MAGIC, FORMAT, _loadOrder, records.size() };
+			{
+				std::ofstream out{ temp, std::ios::binary | std::ios::trunc };
+				out.write(reinterpret_cast<const char*>(std::addressof(header)), sizeof(header));
+				out.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(Record)));
+				if (!out) {
+					logger::error("Failed to write the classification cache"sv);
+					_building.store(false);
+					return;
+				}
+			}
+
+			std::error_code ec;
+			std::filesystem::rename(temp, path, ec);
+			if (auto view = !ec ? View::Open(path, _loadOrder) : nullptr; view) {
+				logger::info("Classification cache rebuilt with {} forms"sv, view->size());
+				_view.store(view.release(), std::memory_order_release);
+			} else {
+				logger::error("Failed to replace the classification cache"sv);
+			}
+			_building.store(false);
+		}).detach();
+	}
+}
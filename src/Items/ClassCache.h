@@ -0,0 +1,81 @@
+#pragma once
+
+namespace Items
+{
+	// Opt-in on-disk cache of the per-form classification, which comes out the same every time a load
+	// order starts. The file is a flat table of records sorted by form ID behind a header holding a
+	// hash of the plugin list, mapped read-only at data load. A stale file is rebuilt on the main thread
+	// once a game loads and only written in the background. Forms created at runtime are never cached,
+	// neither is anything read from keywords, which other plugins hand out after data load.
+	class ClassCache :
+		public RE::BSTEventSink<RE::TESLoadGameEvent>
+	{
+	public:
+		enum Flag : std::uint8_t
+		{
+			kDisplayable = 1 << 0,
+			kTyped = 1 << 1  // type holds the form's kType, clear when it comes from keywords
+		};
+
+		struct Record
+		{
+			RE::FormID formID;
+			std::uint8_t type;  // kType, see kTyped
+			std::uint8_t flags;
+			std::uint16_t pad;
+		};
+		static_assert(sizeof(Record) == 8);
+
+		[[nodiscard]] static ClassCache* GetSingleton()
+		{
+			static ClassCache singleton;
+			return std::addressof(singleton);
+		}
+
+		// Call at kDataLoaded, before anything that reads the cache
+		static void Init();
+
+		// Safe from any thread, nullptr when the cache is off or doesn't hold the form
+		[[nodiscard]] static const Record* Find(RE::FormID a_formID) noexcept;
+
+	protected:
+		using EventResult = RE::BSEventNotifyControl;
+
+		// The MCM toggle lives in the save, so it is only known once a game is loaded. The event is
+		// sent on the main thread, where the forms may be read
+		EventResult ProcessEvent(const RE::TESLoadGameEvent* a_event, RE::BSTEventSource<RE::TESLoadGameEvent>*) override;
+
+	private:
+		struct Header
+		{
+			std::uint32_t magic;
+			std::uint32_t format;
+			std::uint64_t loadOrder;
+			std::uint64_t count;
+		};
+
+		class View;
+
+		ClassCache() = default;
+		ClassCache(const ClassCache&) = delete;
+		ClassCache(ClassCache&&) = delete;
+
+		~ClassCache() = default;
+
+		ClassCache& operator=(const ClassCache&) = delete;
+		ClassCache& operator=(ClassCache&&) = delete;
+
+		[[nodiscard]] static std::uint64_t HashLoadOrder();
+		[[nodiscard]] static std::filesystem::path Path();
+
+		void Rebuild();
+
+		static constexpr std::uint32_t MAGIC{ 0x43434C51 };  // "QLCC"
+		static constexpr std::uint32_t FORMAT{ 2 };
+
+		std::uint64_t _loadOrder{ 0 };
+		std::atomic<const View*> _view{ nullptr };  // published once, never unmapped
+		std::atomic_bool _enabled{ false };
+		std::atomic_bool _building{ false };
+	};
+}
@@ -0,0 +1,95 @@
+#include "Items/Classifier.h"
+
+namespace Items
+{
+	Classifier::Classifier()
+	{
+		// Leave a core to the game's own threads
+		const auto cores = std::thread::hardware_concurrency();
+		const auto count = std::clamp<std::size_t>(cores > 1 ? cores - 1 : 1, 1, MAX_WORKERS);
+
+		_workers.reserve(count);
+		for (std::size_t i = 0; i < count; ++i) {
+			_workers.emplace_back([this](std::stop_token a_stop) { Run(a_stop); });
+		}
+		logger::info("Started {} classifier workers"sv, count);
+	}
+
+	std::uint64_t Classifier::Submit(std::vector<ClassifyInput> a_inputs)
+	{
+		auto batch = std::make_shared<Batch>();
+		batch->ticket = _tickets.fetch_add(1, std::memory_order_relaxed) + 1;
+		batch->inputs = std::move(a_inputs);
+		batch->rows.resize(batch->inputs.size());
+
+		const auto ticket = batch->ticket;
+		if (batch->inputs.empty()) {
+			Publish(*batch);
+			return ticket;
+		}
+
+		{
+			std::scoped_lock l{ _lock };
+			_batch = std::move(batch);
+		}
+		_wake.notify_all();
+		return ticket;
+	}
+
+	void Classifier::Run(std::stop_token a_stop)
+	{
+		std::uint64_t seen = 0;
+		while (!a_stop.stop_requested()) {
+			std::shared_ptr<Batch> batch;
+			{
+				std::unique_lock l{ _lock };
+				if (!_wake.wait(l, a_stop, [&]() { return _batch && _batch->ticket != seen; })) {
+					return;
+				}
+				batch = _batch;
+				seen = batch->ticket;
+			}
+
+			Work(*batch);
+		}
+	}
+
+	void Classifier::Work(Batch& a_batch)
+	{
+		const auto size = a_batch.inputs.size();
+		while (!Superseded(a_batch)) {
+			const auto begin = a_batch.next.fetch_add(CHUNK_SIZE, std::memory_order_relaxed);
+			if (begin >= size) {
+				return;
+			}
+
+			const auto end = std::min(begin + CHUNK_SIZE, size);
+			for (auto i = begin; i < end; ++i) {
+				a_batch.rows[i] = GFxItem::Classify(a_batch.inputs[i]);
+			}
+
+			// Whoever finishes the last chunk hands the batch over
+			const auto count = end - begin;
+			if (a_batch.done.fetch_add(count, std::memory_order_acq_rel) + count == size) {
+				Publish(a_batch);
+				return;
+			}
+		}
+	}
+
+	void Classifier::Publish(Batch& a_batch)
+	{
+		auto result = std::make_unique<Result>(a_batch.ticket, std::move(a_batch.rows));
+
+		// A stale batch finishing late must not displace a newer result the menu hasn't taken yet
+		auto current = _finished.load(std::memory_order_acquire);
+		do {
+			if (current && current->ticket > result->ticket) {
+				return;
+			}
+		} while (!_finished.compare_exchange_weak(current, result.get(), std::memory_order_acq_rel, std::memory_order_acquire));
+
+		result.release();
+		delete current;
+	}
+}
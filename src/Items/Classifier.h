@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Items/GFxItem.h"
+
+namespace Items
+{
+	// Classifies rows on a small pool of worker threads. The menu snapshots its rows on the main
+	// thread and submits them as one batch, finished batches come back through a single atomic slot
+	// the menu polls once per tick. Neither side ever waits on the other.
+	class Classifier
+	{
+	public:
+		struct Result
+		{
+			std::uint64_t ticket;
+			std::vector<Classification> rows;  // in submission order
+		};
+
+		[[nodiscard]] static Classifier& GetSingleton()
+		{
+			// Never destroyed, joining the workers during DLL unload would deadlock on the loader lock
+			static auto singleton = new Classifier();
+			return *singleton;
+		}
+
+		// Returns the ticket the batch's result will carry, a newer submission supersedes older ones
+		[[nodiscard]] std::uint64_t Submit(std::vector<ClassifyInput> a_inputs);
+
+		// Takes the finished batch waiting in the slot, if any
+		[[nodiscard]] std::unique_ptr<Result> Poll() noexcept
+		{
+			return std::unique_ptr<Result>{ _finished.exchange(nullptr, std::memory_order_acq_rel) };
+		}
+
+	private:
+		struct Batch
+		{
+			std::uint64_t ticket;
+			std::vector<ClassifyInput> inputs;
+			std::vector<Classification> rows;
+			std::atomic_size_t next{ 0 };
+			std::atomic_size_t done{ 0 };
+		};
+
+		Classifier();
+		Classifier(const Classifier&) = delete;
+		Classifier(Classifier&&) = delete;
+
+		~Classifier() = default;
+
+		Classifier& operator=(const Classifier&) = delete;
+		Classifier& operator=(Classifier&&) = delete;
+
+		void Run(std::stop_token a_stop);
+		void Work(Batch& a_batch);
+		void Publish(Batch& a_batch);
+
+		[[nodiscard]] bool Superseded(const Batch& a_batch) const noexcept
+		{
+			return a_batch.ticket != _tickets.load(std::memory_order_relaxed);
+		}
+
+		static constexpr std::size_t CHUNK_SIZE{ 8 };  // rows claimed per worker step
+		static constexpr std::size_t MAX_WORKERS{ 3 };
+
+		std::mutex _lock;
+		std::condition_variable_any _wake;
+		std::shared_ptr<Batch> _batch;  // the latest submission, guarded by _lock
+		std::atomic<Result*> _finished{ nullptr };
+		std::atomic_uint64_t _tickets{ 0 };
+		std::vector<std::jthread> _workers;
+	};
+}
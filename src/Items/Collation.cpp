@@ -0,0 +1,287 @@
+#include "Items/Collation.h"
+
+namespace Items
+{
+	namespace
+	{
+		[[nodiscard]] constexpr std::uint32_t Weight(char32_t a_base, std::uint32_t a_rank = 0) noexcept
+		{
+			return (static_cast<std::uint32_t>(a_base) << 8) | a_rank;
+		}
+
+		// Letters the language sorts as their own letter, right after the base letter
+		constexpr frozen::map<char32_t, std::uint32_t, 1> SPANISH{
+			{ U'ñ', Weight(U'n', 1) },
+		};
+
+		constexpr frozen::map<char32_t, std::uint32_t, 9> POLISH{
+			{ U'ą', Weight(U'a', 1) },
+			{ U'ć', Weight(U'c', 1) },
+			{ U'ę', Weight(U'e', 1) },
+			{ U'ł', Weight(U'l', 1) },
+			{ U'ń', Weight(U'n', 1) },
+			{ U'ó', Weight(U'o', 1) },
+			{ U'ś', Weight(U's', 1) },
+			{ U'ź', Weight(U'z', 1) },
+			{ U'ż', Weight(U'z', 2) },
+		};
+
+		constexpr frozen::map<char32_t, std::uint32_t, 1> RUSSIAN{
+			{ U'ё', Weight(U'е', 1) },
+		};
+
+		// Base letters of U+00E0-U+00FF, zero where the code point is its own letter
+		constexpr std::string_view LATIN1_BASE{
+			"aaaaaa\0ceeeeiiii"
+			"dnooooo\0ouuuuy\0y"sv
+		};
+		static_assert(LATIN1_BASE.size() == 0x20);
+
+		// Base letters of U+0100-U+017F, upper and lower case alike
+		constexpr std::string_view LATIN_EXT_A_BASE{
+			"aaaaaa"
+			"cccccccc"
+			"dddd"
+			"eeeeeeeeee"
+			"gggggggg"
+			"hhhh"
+			"iiiiiiiiii"
+			"ii"
+			"jj"
+			"kkk"
+			"llllllllll"
+			"nnnnnnnnn"
+			"oooooo"
+			"oo"
+			"rrrrrr"
+			"ssssssss"
+			"tttttt"
+			"uuuuuuuuuuuu"
+			"ww"
+			"yyy"
+			"zzzzzz"
+			"s"sv
+		};
+		static_assert(LATIN_EXT_A_BASE.size() == 0x80);
+
+		[[nodiscard]] char32_t BaseLetter(char32_t a_char) noexcept
+		{
+			if (a_char >= 0xE0 && a_char <= 0xFF) {
+				const auto base = LATIN1_BASE[a_char - 0xE0];
+				return base != '\0' ? static_cast<char32_t>(base) : a_char;
+			} else if (a_char >= 0x100 && a_char <= 0x17F) {
+				return static_cast<char32_t>(LATIN_EXT_A_BASE[a_char - 0x100]);
+			} else {
+				return a_char;
+			}
+		}
+
+		// Reads one code point, bytes that do not start a valid sequence are taken as Latin-1
+		[[nodiscard]] char32_t Decode(std::string_view a_utf8, std::size_t& a_pos) noexcept
+		{
+			const auto byte = [&](std::size_t a_i) {
+				return static_cast<std::uint8_t>(a_utf8[a_i]);
+			};
+
+			const auto lead = byte(a_pos);
+			std::size_t length = 0;
+			char32_t result = 0;
+			if (lead < 0x80) {
+				++a_pos;
+				return lead;
+			} else if ((lead & 0xE0) == 0xC0) {
+				length = 2;
+				result = lead & 0x1F;
+			} else if ((lead & 0xF0) == 0xE0) {
+				length = 3;
+				result = lead & 0x0F;
+			} else if ((lead & 0xF8) == 0xF0) {
+				length = 4;
+				result = lead & 0x07;
+			}
+
+			if (length == 0 || a_pos + length > a_utf8.size()) {
+				++a_pos;
+				return lead;
+			}
+
+			for (std::size_t i = 1; i < length; ++i) {
+				const auto next = byte(a_pos + i);
+				if ((next & 0xC0) != 0x80) {
+					++a_pos;
+					return lead;
+				}
+				result = (result << 6) | (next & 0x3F);
+			}
+
+			a_pos += length;
+			return result;
+		}
+
+		void AppendUTF8(std::string& a_out, char32_t a_char)
+		{
+			if (a_char < 0x80) {
+				a_out.push_back(static_cast<char>(a_char));
+			} else if (a_char < 0x800) {
+				a_out.push_back(static_cast<char>(0xC0 | (a_char >> 6)));
+				a_out.push_back(static_cast<char>(0x80 | (a_char & 0x3F)));
+			} else if (a_char < 0x10000) {
+				a_out.push_back(static_cast<char>(0xE0 | (a_char >> 12)));
+				a_out.push_back(static_cast<char>(0x80 | ((a_char >> 6) & 0x3F)));
+				a_out.push_back(static_cast<char>(0x80 | (a_char & 0x3F)));
+			} else {
+				a_out.push_back(static_cast<char>(0xF0 | (a_char >> 18)));
+				a_out.push_back(static_cast<char>(0x80 | ((a_char >> 12) & 0x3F)));
+				a_out.push_back(static_cast<char>(0x80 | ((a_char >> 6) & 0x3F)));
+				a_out.push_back(static_cast<char>(0x80 | (a_char & 0x3F)));
+			}
+		}
+
+		// Big endian, so byte order is weight order
+		void AppendWeight(std::string& a_key, std::uint32_t a_weight)
+		{
+			a_key.push_back(static_cast<char>(a_weight >> 24));
+			a_key.push_back(static_cast<char>(a_weight >> 16));
+			a_key.push_back(static_cast<char>(a_weight >> 8));
+			a_key.push_back(static_cast<char>(a_weight));
+		}
+
+		template <std::size_t N>
+		[[nodiscard]] std::optional<std::uint32_t> Find(const frozen::map<char32_t, std::uint32_t, N>& a_map, char32_t a_char)
+		{
+			const auto it = a_map.find(a_char);
+			return it != a_map.end() ? std::make_optional(it->second) : std::nullopt;
+		}
+
+		[[nodiscard]] std::optional<std::uint32_t> Tailored(Collation::Language a_language, char32_t a_char)
+		{
+			using Language = Collation::Language;
+			switch (a_language) {
+			case Language::kSpanish:
+				return Find(SPANISH, a_char);
+			case Language::kPolish:
+				return Find(POLISH, a_char);
+			case Language::kRussian:
+				return Find(RUSSIAN, a_char);
+			case Language::kJapanese:
+				// Katakana sorts with the matching hiragana, the secondary weights keep them apart
+				if (a_char >= 0x30A1 && a_char <= 0x30F6) {
+					return Weight(a_char - 0x60);
+				}
+				return std::nullopt;
+			case Language::kDefault:
+			default:
+				return std::nullopt;
+			}
+		}
+
+		void AppendPrimary(std::string& a_key, Collation::Language a_language, char32_t a_char)
+		{
+			if (const auto tailored = Tailored(a_language, a_char); tailored) {
+				AppendWeight(a_key, *tailored);
+				return;
+			}
+
+			switch (a_char) {
+			case U'ß':
+				AppendWeight(a_key, Weight(U's'));
+				AppendWeight(a_key, Weight(U's'));
+				break;
+			case U'æ':
+				AppendWeight(a_key, Weight(U'a'));
+				AppendWeight(a_key, Weight(U'e'));
+				break;
+			case U'œ':
+				AppendWeight(a_key, Weight(U'o'));
+				AppendWeight(a_key, Weight(U'e'));
+				break;
+			default:
+				AppendWeight(a_key, Weight(BaseLetter(a_char)));
+				break;
+			}
+		}
+	}
+
+	void Collation::Init()
+	{
+		static constexpr std::array languages{
+			std::make_pair("SPANISH"sv, Language::kSpanish),
+			std::make_pair("POLISH"sv, Language::kPolish),
+			std::make_pair("RUSSIAN"sv, Language::kRussian),
+			std::make_pair("JAPANESE"sv, Language::kJapanese),
+		};
+
+		const auto setting = RE::GetINISetting("sLanguage:General");
+		const auto name = setting ? stl::safe_string(setting->GetString()) : ""sv;
+
+		_language = Language::kDefault;
+		for (const auto& [id, language] : languages) {
+			if (name.size() == id.size() && _strnicmp(name.data(), id.data(), id.size()) == 0) {
+				_language = language;
+				break;
+			}
+		}
+
+		logger::info("Collating names for language \"{}\""sv, name);
+	}
+
+	void Collation::AppendKey(std::string& a_key, std::string_view a_utf8)
+	{
+		const auto language = _language;
+		for (std::size_t pos = 0; pos < a_utf8.size();) {
+			AppendPrimary(a_key, language, Fold(Decode(a_utf8, pos)));
+		}
+
+		AppendWeight(a_key, 0);
+
+		for (std::size_t pos = 0; pos < a_utf8.size();) {
+			AppendWeight(a_key, Fold(Decode(a_utf8, pos)));
+		}
+	}
+
+	void Collation::AppendFolded(std::string& a_out, std::string_view a_utf8)
+	{
+		for (std::size_t pos = 0; pos < a_utf8.size();) {
+			AppendUTF8(a_out, Fold(Decode(a_utf8, pos)));
+		}
+	}
+
+	void Collation::AppendFolded(std::string& a_out, char32_t a_char)
+	{
+		AppendUTF8(a_out, Fold(a_char));
+	}
+
+	// Simple case folding for the scripts the game ships fonts for
+	char32_t Collation::Fold(char32_t a_char) noexcept
+	{
+		if (a_char < 0x80) {
+			return a_char >= U'A' && a_char <= U'Z' ? a_char + 0x20 : a_char;
+		} else if (a_char >= 0xC0 && a_char <= 0xDE && a_char != 0xD7) {
+			return a_char + 0x20;
+		} else if (a_char >= 0x100 && a_char <= 0x17F) {
+			if (a_char == 0x130) {
+				return U'i';
+			} else if (a_char == 0x178) {
+				return 0xFF;
+			} else if (a_char == 0x17F) {
+				return U's';
+			} else if ((a_char >= 0x139 && a_char <= 0x148) || (a_char >= 0x179 && a_char <= 0x17E)) {
+				return (a_char & 1) != 0 ? a_char + 1 : a_char;
+			} else if (a_char != 0x131 && a_char != 0x138 && a_char != 0x149) {
+				return (a_char & 1) == 0 ? a_char + 1 : a_char;
+			} else {
+				return a_char;
+			}
+		} else if (a_char >= 0x391 && a_char <= 0x3A9 && a_char != 0x3A2) {
+			return a_char + 0x20;
+		} else if (a_char >= 0x400 && a_char <= 0x40F) {
+			return a_char + 0x50;
+		} else if (a_char >= 0x410 && a_char <= 0x42F) {
+			return a_char + 0x20;
+		} else if (a_char >= 0xFF21 && a_char <= 0xFF3A) {
+			return a_char + 0x20;
+		} else {
+			return a_char;
+		}
+	}
+}
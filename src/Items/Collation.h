@@ -0,0 +1,39 @@
+#pragma once
+
+namespace Items
+{
+	// Turns display names into binary sort keys so name order is a plain byte compare. Keys hold the
+	// primary weights (base letters, tailored for the game language) followed by the case folded code
+	// points, so names that only differ in accents still get a stable order.
+	class Collation
+	{
+	public:
+		enum class Language
+		{
+			kDefault,  // accents are ignored at the primary level, other scripts sort by code point
+			kSpanish,
+			kPolish,
+			kRussian,
+			kJapanese
+		};
+
+		// Picks the tailoring from sLanguage:General, call once the INIs are loaded
+		static void Init();
+
+		[[nodiscard]] static Language GetLanguage() noexcept { return _language; }
+
+		// Appends the sort key of a UTF-8 string
+		static void AppendKey(std::string& a_key, std::string_view a_utf8);
+
+		// Appends the case folded UTF-8 of a string, the form searches match against
+		static void AppendFolded(std::string& a_out, std::string_view a_utf8);
+
+		// Appends a single code point as case folded UTF-8
+		static void AppendFolded(std::string& a_out, char32_t a_char);
+
+		[[nodiscard]] static char32_t Fold(char32_t a_char) noexcept;
+
+	private:
+		static inline Language _language{ Language::kDefault };
+	};
+}
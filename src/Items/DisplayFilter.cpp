@@ -0,0 +1,149 @@
+#include "Items/DisplayFilter.h"
+
+#include "Diagnostics/Watchdog.h"
+#include "Items/ClassCache.h"
+
+namespace Items
+{
+	void DisplayFilter::Init()
+	{
+		static constexpr std::array types{
+			RE::FormType::Scroll,
+			RE::FormType::Armor,
+			RE::FormType::Book,
+			RE::FormType::Ingredient,
+			RE::FormType::Light,
+			RE::FormType::Misc,
+			RE::FormType::Weapon,
+			RE::FormType::Ammo,
+			RE::FormType::KeyMaster,
+			RE::FormType::AlchemyItem,
+			RE::FormType::Note,
+			RE::FormType::SoulGem,
+		};
+
+		auto dataHandler = RE::TESDataHandler::GetSingleton();
+		if (!dataHandler) {
+			return;
+		}
+
+		auto filter = GetSingleton();
+		std::size_t listed = 0;
+		for (const auto type : types) {
+			for (const auto form : dataHandler->GetFormArray(type)) {
+				const auto object = form ? form->As<RE::TESBoundObject>() : nullptr;
+				if (!object || (object->GetFormID() >> 24) == RUNTIME_INDEX) {
+					continue;
+				}
+
+				const auto record = ClassCache::Find(object->GetFormID());
+				if (record ? (record->flags & ClassCache::kDisplayable) != 0 : Evaluate(*object)) {
+					filter->Store(object->GetFormID(), true);
+					++listed;
+				}
+			}
+		}
+
+		auto scripts = RE::ScriptEventSourceHolder::GetSingleton();
+		if (scripts) {
+			scripts->AddEventSink<RE::TESFormDeleteEvent>(filter);
+		}
+
+		logger::info("Display filter holds {} listable forms"sv, listed);
+	}
+
+	bool DisplayFilter::Evaluate(const RE::TESBoundObject& a_object)
+	{
+		switch (a_object.GetFormType()) {
+		case RE::FormType::Scroll:
+		case RE::FormType::Armor:
+		case RE::FormType::Book:
+		case RE::FormType::Ingredient:
+		case RE::FormType::Misc:
+		case RE::FormType::Weapon:
+		case RE::FormType::Ammo:
+		case RE::FormType::KeyMaster:
+		case RE::FormType::AlchemyItem:
+		case RE::FormType::Note:
+		case RE::FormType::SoulGem:
+			break;
+		case RE::FormType::Light:
+			{
+				auto& light = static_cast<const RE::TESObjectLIGH&>(a_object);
+				if (!light.CanBeCarried()) {
+					return false;
+				}
+			}
+			break;
+		default:
+			return false;
+		}
+
+		if (!a_object.GetPlayable()) {
+			return false;
+		}
+
+		auto name = a_object.GetName();
+		if (!name || name[0] == '\0') {
+			return false;
+		}
+
+		return true;
+	}
+
+	auto DisplayFilter::ProcessEvent(const RE::TESFormDeleteEvent* a_event, RE::BSTEventSource<RE::TESFormDeleteEvent>*)
+		-> EventResult
+	{
+		Diagnostics::Watchdog::Scope watch{ "DisplayFilter::TESFormDeleteEvent"sv };
+
+		// Runtime IDs are recycled, the next form to get this one is evaluated afresh
+		if (a_event && (a_event->formID >> 24) == RUNTIME_INDEX) {
+			std::scoped_lock l{ _runtimeLock };
+			Set(_runtimeKnown, a_event->formID & 0xFFFFFF, false);
+		}
+
+		return EventResult::kContinue;
+	}
+
+	bool DisplayFilter::Test(const RE::TESBoundObject& a_object)
+	{
+		const auto formID = a_object.GetFormID();
+		const auto index = formID >> 24;
+		if (index < LIGHT_INDEX) {
+			return Get(_files[index], formID & 0xFFFFFF);
+		} else if (index == LIGHT_INDEX) {
+			const auto file = (formID >> 12) & 0xFFF;
+			return file < _lightFiles.size() && Get(_lightFiles[file], formID & 0xFFF);
+		}
+
+		const auto local = formID & 0xFFFFFF;
+		{
+			std::scoped_lock l{ _runtimeLock };
+			if (Get(_runtimeKnown, local)) {
+				return Get(_runtime, local);
+			}
+		}
+
+		const auto result = Evaluate(a_object);
+		Store(formID, result);
+		return result;
+	}
+
+	void DisplayFilter::Store(RE::FormID a_formID, bool a_value)
+	{
+		const auto index = a_formID >> 24;
+		if (index < LIGHT_INDEX) {
+			Set(_files[index], a_formID & 0xFFFFFF, a_value);
+		} else if (index == LIGHT_INDEX) {
+			const auto file = (a_formID >> 12) & 0xFFF;
+			if (file >= _lightFiles.size()) {
+				_lightFiles.resize(file + 1);
+			}
+			Set(_lightFiles[file], a_formID & 0xFFF, a_value);
+		} else {
+			std::scoped_lock l{ _runtimeLock };
+			Set(_runtimeKnown, a_formID & 0xFFFFFF, true);
+			Set(_runtime, a_formID & 0xFFFFFF, a_value);
+		}
+	}
+}
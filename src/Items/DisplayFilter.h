@@ -0,0 +1,75 @@
+#pragma once
+
+namespace Items
+{
+	// Which objects the menu lists, answered from a bitmap indexed by form ID. The bits are filled at
+	// data load for every form in the data handler's arrays of listable types; forms created at
+	// runtime are evaluated on first sight and remembered until they are deleted.
+	class DisplayFilter :
+		public RE::BSTEventSink<RE::TESFormDeleteEvent>
+	{
+	public:
+		[[nodiscard]] static DisplayFilter* GetSingleton()
+		{
+			static DisplayFilter singleton;
+			return std::addressof(singleton);
+		}
+
+		// Call at kDataLoaded
+		static void Init();
+
+		[[nodiscard]] static bool CanDisplay(const RE::TESBoundObject& a_object)
+		{
+			return GetSingleton()->Test(a_object);
+		}
+
+		// The rules the bitmap caches
+		[[nodiscard]] static bool Evaluate(const RE::TESBoundObject& a_object);
+
+	protected:
+		using EventResult = RE::BSEventNotifyControl;
+
+		EventResult ProcessEvent(const RE::TESFormDeleteEvent* a_event, RE::BSTEventSource<RE::TESFormDeleteEvent>*) override;
+
+	private:
+		using bits_t = std::vector<std::uint64_t>;
+
+		DisplayFilter() = default;
+		DisplayFilter(const DisplayFilter&) = delete;
+		DisplayFilter(DisplayFilter&&) = delete;
+
+		~DisplayFilter() = default;
+
+		DisplayFilter& operator=(const DisplayFilter&) = delete;
+		DisplayFilter& operator=(DisplayFilter&&) = delete;
+
+		[[nodiscard]] static bool Get(const bits_t& a_bits, std::uint32_t a_index) noexcept
+		{
+			const auto word = a_index / 64;
+			return word < a_bits.size() && ((a_bits[word] >> (a_index % 64)) & 1) != 0;
+		}
+
+		static void Set(bits_t& a_bits, std::uint32_t a_index, bool a_value)
+		{
+			const auto word = a_index / 64;
+			if (word >= a_bits.size()) {
+				a_bits.resize(word + 1);
+			}
+
+			const auto mask = std::uint64_t{ 1 } << (a_index % 64);
+			a_bits[word] = a_value ? a_bits[word] | mask : a_bits[word] & ~mask;
+		}
+
+		[[nodiscard]] bool Test(const RE::TESBoundObject& a_object);
+		void Store(RE::FormID a_formID, bool a_value);
+
+		static constexpr std::uint32_t LIGHT_INDEX{ 0xFE };
+		static constexpr std::uint32_t RUNTIME_INDEX{ 0xFF };
+
+		std::array<bits_t, LIGHT_INDEX> _files;  // by load order index, local form ID
+		std::vector<bits_t> _lightFiles;  // by light file index, 12 bit local form ID
+		std::mutex _runtimeLock;
+		bits_t _runtimeKnown;
+		bits_t _runtime;
+	};
+}
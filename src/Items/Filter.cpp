@@ -0,0 +1,63 @@
+#include "Items/Filter.h"
+
+namespace Items
+{
+	namespace
+	{
+		using namespace FilterKernels;
+
+		struct Dispatch
+		{
+			Dispatch()
+			{
+				if (HasAVX2()) {
+					kernel = EvaluateAVX2;
+					name = "AVX2"sv;
+				} else if (HasSSE2()) {
+					kernel = EvaluateSSE;
+					name = "SSE2"sv;
+				}
+			}
+
+			kernel_t kernel{ EvaluateScalar };
+			std::string_view name{ "scalar"sv };
+		};
+
+		[[nodiscard]] const Dispatch& GetDispatch()
+		{
+			static const Dispatch dispatch;
+			return dispatch;
+		}
+	}
+
+	auto Filter::FromSettings()
+		-> Params
+	{
+		Params params;
+		params.rejectTraits |= Settings::HideStolen() ? kTraitStolen : 0;
+		params.rejectTraits |= Settings::HideQuestItems() ? kTraitQuestItem : 0;
+		params.rejectTraits |= Settings::HideReadBooks() ? kTraitReadBook : 0;
+		params.rejectTraits |= Settings::HideKnownEnchantments() ? kTraitKnownEnchantment : 0;
+		params.minValuePerWeight = Settings::MinValuePerWeight();
+		return params;
+	}
+
+	void Filter::Evaluate(const ItemStore& a_store, const Params& a_params, std::vector<std::uint8_t>& a_mask)
+	{
+		const FilterKernels::Columns cols{
+			a_store.Values().data(),
+			a_store.Weights().data(),
+			a_store.Counts().data(),
+			a_store.Traits().data(),
+			a_store.Rows()
+		};
+
+		a_mask.assign((cols.size + 7) / 8, 0);
+		FilterKernels::Evaluate(GetDispatch().kernel, cols, a_params, a_mask.data());
+	}
+
+	std::string_view Filter::PathName()
+	{
+		return GetDispatch().name;
+	}
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Items/FilterKernels.h"
+#include "Items/ItemStore.h"
+
+namespace Items
+{
+	// Evaluates the user's row filters over the store columns, eight rows per mask byte
+	class Filter
+	{
+	public:
+		using Params = FilterKernels::Params;
+
+		[[nodiscard]] static Params FromSettings();
+
+		// Sets the bit of every row with a positive count that passes a_params, low bit first
+		static void Evaluate(const ItemStore& a_store, const Params& a_params, std::vector<std::uint8_t>& a_mask);
+
+		[[nodiscard]] static std::string_view PathName();
+	};
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+// Engine independent, Filter.cpp and the host bench in bench/ both build these
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <immintrin.h>
+#ifdef _MSC_VER
+#	include <intrin.h>
+#	define FILTER_TARGET(a_isa)
+#else
+#	include <cpuid.h>
+#	define FILTER_TARGET(a_isa) __attribute__((target(a_isa)))
+#endif
+
+namespace Items::FilterKernels
+{
+	struct Params
+	{
+		std::uint32_t rejectTraits{ 0 };  // rows with any of these Trait bits are hidden
+		float minValuePerWeight{ 0.0F };  // disabled when <= 0, weightless rows always pass
+	};
+
+	struct Columns
+	{
+		const std::int32_t* values;
+		const float* weights;
+		const std::int32_t* counts;
+		const std::uint32_t* traits;
+		std::size_t size;
+	};
+
+	// Each kernel fills whole mask bytes and returns how many rows it covered
+	using kernel_t = std::size_t (*)(const Columns&, const Params&, std::uint8_t*);
+
+	[[nodiscard]] inline bool Pass(const Columns& a_cols, const Params& a_params, std::size_t a_row)
+	{
+		return a_cols.counts[a_row] > 0 &&
+		       (a_cols.traits[a_row] & a_params.rejectTraits) == 0 &&
+		       (a_params.minValuePerWeight <= 0.0F ||
+				   static_cast<float>(a_cols.values[a_row]) >= a_params.minValuePerWeight * a_cols.weights[a_row]);
+	}
+
+	inline std::size_t EvaluateScalar(const Columns&, const Params&, std::uint8_t*)
+	{
+		return 0;  // everything is left to the tail loop
+	}
+
+	inline std::size_t EvaluateSSE(const Columns& a_cols, const Params& a_params, std::uint8_t* a_mask)
+	{
+		const auto zero = _mm_setzero_si128();
+		const auto reject = _mm_set1_epi32(static_cast<int>(a_params.rejectTraits));
+		const auto minRatio = _mm_set1_ps(a_params.minValuePerWeight);
+		const auto ratioOff = _mm_castsi128_ps(_mm_set1_epi32(a_params.minValuePerWeight <= 0.0F ? -1 : 0));
+
+		const auto quad = [&](std::size_t a_row) {
+			const auto value = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a_cols.values + a_row)));
+			const auto weight = _mm_loadu_ps(a_cols.weights + a_row);
+			const auto count = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a_cols.counts + a_row));
+			const auto traits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a_cols.traits + a_row));
+
+			const auto ratioOk = _mm_or_ps(_mm_cmpge_ps(value, _mm_mul_ps(weight, minRatio)), ratioOff);
+			const auto countOk = _mm_cmpgt_epi32(count, zero);
+			const auto traitsOk = _mm_cmpeq_epi32(_mm_and_si128(traits, reject), zero);
+			return _mm_movemask_ps(_mm_and_ps(ratioOk, _mm_castsi128_ps(_mm_and_si128(countOk, traitsOk))));
+		};
+
+		std::size_t row = 0;
+		for (; row + 8 <= a_cols.size; row += 8) {
+			a_mask[row / 8] = static_cast<std::uint8_t>(quad(row) | (quad(row + 4) << 4));
+		}
+		return row;
+	}
+
+	FILTER_TARGET("avx2")
+	inline std::size_t EvaluateAVX2(const Columns& a_cols, const Params& a_params, std::uint8_t* a_mask)
+	{
+		const auto zero = _mm256_setzero_si256();
+		const auto reject = _mm256_set1_epi32(static_cast<int>(a_params.rejectTraits));
+		const auto minRatio = _mm256_set1_ps(a_params.minValuePerWeight);
+		const auto ratioOff = _mm256_castsi256_ps(_mm256_set1_epi32(a_params.minValuePerWeight <= 0.0F ? -1 : 0));
+
+		std::size_t row = 0;
+		for (; row + 8 <= a_cols.size; row += 8) {
+			const auto value = _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a_cols.values + row)));
+			const auto weight = _mm256_loadu_ps(a_cols.weights + row);
+			const auto count = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a_cols.counts + row));
+			const auto traits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a_cols.traits + row));
+
+			const auto ratioOk = _mm256_or_ps(_mm256_cmp_ps(value, _mm256_mul_ps(weight, minRatio), _CMP_GE_OQ), ratioOff);
+			const auto countOk = _mm256_cmpgt_epi32(count, zero);
+			const auto traitsOk = _mm256_cmpeq_epi32(_mm256_and_si256(traits, reject), zero);
+			const auto pass = _mm256_and_ps(ratioOk, _mm256_castsi256_ps(_mm256_and_si256(countOk, traitsOk)));
+			a_mask[row / 8] = static_cast<std::uint8_t>(_mm256_movemask_ps(pass));
+		}
+		_mm256_zeroupper();
+		return row;
+	}
+
+	inline void CPUID(std::array<int, 4>& a_info, int a_leaf, int a_subleaf = 0)
+	{
+#ifdef _MSC_VER
+		__cpuidex(a_info.data(), a_leaf, a_subleaf);
+#else
+		unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+		__cpuid_count(a_leaf, a_subleaf, eax, ebx, ecx, edx);
+		a_info = { static_cast<int>(eax), static_cast<int>(ebx), static_cast<int>(ecx), static_cast<int>(edx) };
+#endif
+	}
+
+	FILTER_TARGET("xsave")
+	[[nodiscard]] inline bool HasAVX2()
+	{
+		std::array<int, 4> info{};
+		CPUID(info, 0);
+		if (info[0] < 7) {
+			return false;
+		}
+
+		CPUID(info, 1);
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+		const bool avx = (info[2] & (1 << 28)) != 0;
+		if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {  // the OS must save the ymm registers
+			return false;
+		}
+
+		CPUID(info, 7);
+		return (info[1] & (1 << 5)) != 0;
+	}
+
+	[[nodiscard]] inline bool HasSSE2()
+	{
+		std::array<int, 4> info{};
+		CPUID(info, 1);
+		return (info[3] & (1 << 26)) != 0;
+	}
+
+	// a_mask holds (size + 7) / 8 zeroed bytes, a_kernel covers what it can and the rest is scalar
+	inline void Evaluate(kernel_t a_kernel, const Columns& a_cols, const Params& a_params, std::uint8_t* a_mask)
+	{
+		auto row = a_kernel(a_cols, a_params, a_mask);
+		for (; row < a_cols.size; ++row) {
+			if (Pass(a_cols, a_params, row)) {
+				a_mask[row / 8] |= static_cast<std::uint8_t>(1u << (row % 8));
+			}
+		}
+	}
+}
@@ -1,5 +1,10 @@
 #include "GFxItem.h"
 
+#include "Items/ClassCache.h"
+#include "Items/InventoryView.h"
+#include "Items/ItemArena.h"
+#include "Items/OwnershipCache.h"
+
 #undef GetModuleHandle
 
 static const char* strIcons[] = {
@@ -120,49 +125,77 @@ static bool comp_installed{};
 
 namespace Items
 {
-	GFxItem::GFxItem(std::ptrdiff_t a_count, bool a_stealing, SKSE::stl::observer<RE::InventoryEntryData*> a_item)
-		: _src(a_item)
+	GFxItem::GFxItem(std::ptrdiff_t a_count, bool a_stealing, SKSE::stl::observer<RE::TESBoundObject*> a_object, RE::ObjectRefHandle a_container, std::pmr::memory_resource& a_arena)
+		: _src(inventory_t{ a_object, a_container })
+		, _arena(std::addressof(a_arena))
 		, _count(a_count)
 		, _stealing(a_stealing)
 	{
-		assert(a_item != nullptr);
+		assert(a_object != nullptr);
+	}
+
+	// Hands a_fn the container's live entry for the row's object. Objects only the base container
+	// holds have no entry, a bare one on the stack stands in so the reads fall back to the object
+	template <class Fn>
+	decltype(auto) GFxItem::WithEntry(Fn&& a_fn) const
+	{
+		const auto& src = std::get<kInventory>(_src);
+		const auto container = src.container.get();
+		if (const auto entry = container ? InventoryView::LookupEntry(*container, *src.object) : nullptr; entry) {
+			return a_fn(*entry);
+		}
+
+		RE::InventoryEntryData bare{ src.object, 0 };
+		return a_fn(bare);
 	}
 
-	GFxItem::GFxItem(std::ptrdiff_t a_count, bool a_stealing, std::span<const RE::ObjectRefHandle> a_items)
+	GFxItem::GFxItem(std::ptrdiff_t a_count, bool a_stealing, std::span<const RE::ObjectRefHandle> a_items, std::pmr::memory_resource& a_arena)
 		: _src(a_items)
+		, _arena(std::addressof(a_arena))
 		, _count(a_count)
 		, _stealing(a_stealing)
 	{}
 
-	int GFxItem::Compare(const GFxItem& a_rhs) const
+	// Rescales the cached totals so a count delta never has to read the entry again
+	void GFxItem::SetCount(std::ptrdiff_t a_count)
 	{
-		if (IsQuestItem() != a_rhs.IsQuestItem()) {
-			return IsQuestItem() ? -1 : 1;
-		} else if (IsKey() != a_rhs.IsKey()) {
-			return IsKey() ? -1 : 1;
-		} else if (IsNote() != a_rhs.IsNote()) {
-			return IsNote() ? -1 : 1;
-		} else if (IsBook() != a_rhs.IsBook()) {
-			return IsBook() ? -1 : 1;
-		} else if (IsGold() != a_rhs.IsGold()) {
-			return IsGold() ? -1 : 1;
-		} else if (IsAmmo() != a_rhs.IsAmmo()) {
-			return IsAmmo() ? -1 : 1;
-		} else if (IsLockpick() != a_rhs.IsLockpick()) {
-			return IsLockpick() ? -1 : 1;
-		} else if (GetValue() != a_rhs.GetValue()) {
-			return GetValue() > a_rhs.GetValue() ? -1 : 1;
-		} else if (const auto alphabetical = _stricmp(GetDisplayName().c_str(), a_rhs.GetDisplayName().c_str());
-				   alphabetical != 0) {
-			return alphabetical < 0 ? -1 : 1;
-		} else if (GetFormID() != a_rhs.GetFormID()) {
-			return GetFormID() < a_rhs.GetFormID() ? -1 : 1;
+		if (_count > 0 && _cache[kValue]) {
+			_cache.Value(_cache.Value() / _count * a_count);
 		} else {
-			return 0;
+			_cache.Invalidate(kValue);
 		}
+
+		if (_count > 0 && _cache[kWeight]) {
+			_cache.Weight(_cache.Weight() / static_cast<double>(_count) * static_cast<double>(a_count));
+		} else {
+			_cache.Invalidate(kWeight);
+		}
+
+		_count = a_count;
 	}
 
-	const std::string& GFxItem::GetDisplayName() const
+	// Packs the category tests that lead the sort order, a higher rank sorts first
+	std::uint8_t GFxItem::GetSortRank() const
+	{
+		const std::array categories{
+			IsQuestItem(),
+			IsKey(),
+			IsNote(),
+			IsBook(),
+			IsGold(),
+			IsAmmo(),
+			IsLockpick()
+		};
+
+		std::uint8_t rank = 0;
+		for (const auto category : categories) {
+			rank = static_cast<std::uint8_t>((rank << 1) | (category ? 1 : 0));
+		}
+		return rank;
+	}
+
+	// Names are interned null terminated, so the views can be compared as C strings
+	std::string_view GFxItem::GetDisplayName() const
 	{
 		if (comp_installed)
 		{
@@ -186,12 +219,13 @@ namespace Items
 			return _cache.DisplayName();
 		}
 
-		std::string result;
+		std::string_view result;
 		switch (_src.index()) {
 		case kInventory: 
 		{
-			const char* display_name = std::get<kInventory>(_src)->GetDisplayName();
-			result = display_name ? display_name : ""sv;
+			result = WithEntry([](RE::InventoryEntryData& a_entry) {
+				return stl::safe_string(a_entry.GetDisplayName());
+			});
 			break;
 		}
 		case kGround:
@@ -209,7 +243,7 @@ namespace Items
 			break;
 		}
 
-		_cache.DisplayName(std::move(result));
+		_cache.DisplayName(ItemArena::Intern(*_arena, result));
 		return _cache.DisplayName();
 	}
 
@@ -222,10 +256,9 @@ namespace Items
 		double result = -1.0;
 		switch (_src.index()) {
 		case kInventory:
-			result =
-				std::get<kInventory>(_src)
-					->GetEnchantmentCharge()
-					.value_or(-1.0);
+			result = WithEntry([](RE::InventoryEntryData& a_entry) {
+				return a_entry.GetEnchantmentCharge().value_or(-1.0);
+			});
 			break;
 		case kGround:
 			for (const auto& handle : std::get<kGround>(_src)) {
@@ -251,7 +284,7 @@ namespace Items
 	bool GFxItem::IsEnchanted() const
 	{
 		if (!_cache[kIsEnchanted]) {
-			SetupEnchantmentFlags();
+			SetEnchantmentFlags(GetEnchantmentType());
 		}
 		return _cache.IsEnchanted();
 	}
@@ -259,7 +292,7 @@ namespace Items
 	bool GFxItem::IsKnownEnchanted() const
 	{
 		if (!_cache[kIsKnownEnchanted]) {
-			SetupEnchantmentFlags();
+			SetEnchantmentFlags(GetEnchantmentType());
 		}
 		return _cache.IsKnownEnchanted();
 	}
@@ -267,7 +300,7 @@ namespace Items
 	bool GFxItem::IsSpecialEnchanted() const
 	{
 		if (!_cache[kIsSpecialEnchanted]) {
-			SetupEnchantmentFlags();
+			SetEnchantmentFlags(GetEnchantmentType());
 		}
 		return _cache.IsSpecialEnchanted();
 	}
@@ -281,7 +314,7 @@ namespace Items
 		auto result = std::numeric_limits<RE::FormID>::max();
 		switch (_src.index()) {
 		case kInventory:
-			if (const auto obj = std::get<kInventory>(_src)->GetObject(); obj) {
+			if (const auto obj = std::get<kInventory>(_src).object; obj) {
 				result = obj->GetFormID();
 			}
 			break;
@@ -310,28 +343,7 @@ namespace Items
 			return _cache.ItemType();
 		}
 
-		auto result = kType::None;
-		switch (_src.index()) {
-		case kInventory:
-			if (const auto obj = std::get<kInventory>(_src)->GetObject(); obj) {
-				result = GetItemType(obj);
-			}
-			break;
-		case kGround:
-			for (const auto& handle : std::get<kGround>(_src)) {
-				const auto item = handle.get();
-				const auto obj = item ? item->GetObjectReference() : nullptr;
-				if (obj) {
-					result = GetItemType(obj);
-					break;
-				}
-			}
-			break;
-		default:
-			assert(false);
-			break;
-		}
-
+		const auto result = GetItemType(Snapshot().object);
 		_cache.ItemType(result);
 		return result;
 	}
@@ -345,7 +357,9 @@ namespace Items
 		auto result = std::numeric_limits<std::ptrdiff_t>::min();
 		switch (_src.index()) {
 		case kInventory:
-			result = std::get<kInventory>(_src)->GetValue() * _count;
+			result = WithEntry([](RE::InventoryEntryData& a_entry) {
+				return a_entry.GetValue();
+			}) * _count;
 			break;
 		case kGround:
 			for (const auto& handle : std::get<kGround>(_src)) {
@@ -375,7 +389,7 @@ namespace Items
 		double result = 0.0;
 		switch (_src.index()) {
 		case kInventory:
-			result = std::get<kInventory>(_src)->GetWeight() * _count;
+			result = std::get<kInventory>(_src).object->GetWeight() * _count;
 			break;
 		case kGround:
 			for (const auto& handle : std::get<kGround>(_src)) {
@@ -405,7 +419,7 @@ namespace Items
 		bool result = false;
 		switch (_src.index()) {
 		case kInventory:
-			if (const auto obj = std::get<kInventory>(_src)->GetObject(); obj) {
+			if (const auto obj = std::get<kInventory>(_src).object; obj) {
 				result = obj->IsAmmo();
 			}
 			break;
@@ -437,7 +451,7 @@ namespace Items
 		bool result = false;
 		switch (_src.index()) {
 		case kInventory:
-			if (const auto obj = std::get<kInventory>(_src)->GetObject(); obj) {
+			if (const auto obj = std::get<kInventory>(_src).object; obj) {
 				result = obj->IsBook();
 			}
 			break;
@@ -473,7 +487,7 @@ namespace Items
 		bool result = false;
 		switch (_src.index()) {
 		case kInventory:
-			if (const auto obj = static_cast<RE::TESObjectBOOK*>(std::get<kInventory>(_src)->GetObject()); obj) {
+			if (const auto obj = static_cast<RE::TESObjectBOOK*>(std::get<kInventory>(_src).object); obj) {
 				result = obj->IsRead();
 			}
 			break;
@@ -505,7 +519,7 @@ namespace Items
 		bool result = false;
 		switch (_src.index()) {
 		case kInventory:
-			if (const auto obj = std::get<kInventory>(_src)->GetObject(); obj) {
+			if (const auto obj = std::get<kInventory>(_src).object; obj) {
 				result = obj->IsGold();
 			}
 			break;
@@ -537,7 +551,7 @@ namespace Items
 		bool result = false;
 		switch (_src.index()) {
 		case kInventory:
-			if (const auto obj = std::get<kInventory>(_src)->GetObject(); obj) {
+			if (const auto obj = std::get<kInventory>(_src).object; obj) {
 				result = obj->IsKey();
 			}
 			break;
@@ -569,7 +583,7 @@ namespace Items
 		bool result = false;
 		switch (_src.index()) {
 		case kInventory:
-			if (const auto obj = std::get<kInventory>(_src)->GetObject(); obj) {
+			if (const auto obj = std::get<kInventory>(_src).object; obj) {
 				result = obj->IsLockpick();
 			}
 			break;
@@ -601,7 +615,7 @@ namespace Items
 		bool result = false;
 		switch (_src.index()) {
 		case kInventory:
-			if (const auto obj = std::get<kInventory>(_src)->GetObject(); obj) {
+			if (const auto obj = std::get<kInventory>(_src).object; obj) {
 				result = obj->IsNote();
 			}
 			break;
@@ -633,7 +647,9 @@ namespace Items
 		bool result = false;
 		switch (_src.index()) {
 		case kInventory:
-			result = std::get<kInventory>(_src)->IsQuestObject();
+			result = WithEntry([](RE::InventoryEntryData& a_entry) {
+				return a_entry.IsQuestObject();
+			});
 			break;
 		case kGround:
 			for (const auto& handle : std::get<kGround>(_src)) {
@@ -664,12 +680,17 @@ namespace Items
 		if (player) {
 			switch (_src.index()) {
 			case kInventory:
-				result = !std::get<kInventory>(_src)->IsOwnedBy(player, !_stealing);
+			{
+				// Entries without an owner of their own get the container level answer
+				result = WithEntry([&](RE::InventoryEntryData& a_entry) {
+					return OwnershipCache::HasOwnOwnership(a_entry) ? !a_entry.IsOwnedBy(player, !_stealing) : _stealing;
+				});
 				break;
+			}
 			case kGround:
 				for (const auto& handle : std::get<kGround>(_src)) {
 					const auto item = handle.get();
-					if (item && item->IsCrimeToActivate()) {
+					if (item && OwnershipCache::GetSingleton()->IsCrimeToActivate(*item)) {
 						result = true;
 						break;
 					}
@@ -718,39 +739,58 @@ namespace Items
 		return result;
 	}
 
-	RE::GFxValue GFxItem::GFxValue(RE::GFxMovieView& a_view) const
+	std::uint32_t GFxItem::GetIconIndex() const
 	{
-		RE::GFxValue value;
-		a_view.CreateObject(std::addressof(value));
-		value.SetMember("displayName", { static_cast<std::string_view>(GetDisplayName()) });
-		value.SetMember("count", { _count });
-		value.SetMember("stolen", { IsStolen() });
-		value.SetMember("value", { GetValue() });
-		value.SetMember("iconLabel", { GetItemIconLabel(GetItemType()) });
-
-		const auto weight = GetWeight();
-		if (weight >= 0)
-			value.SetMember("weight", { GetWeight() });
+		const auto index = static_cast<std::uint32_t>(GetItemType());
+		return index < std::size(strIcons) ? index : 0;
+	}
+
+	std::uint32_t GFxItem::GetRowFlags() const
+	{
+		std::uint32_t flags = 0;
+		const auto set = [&](RowFlag a_flag, bool a_value) {
+			if (a_value) {
+				flags |= a_flag;
+			}
+		};
+
+		set(kRowStolen, IsStolen());
+		set(kRowHasWeight, GetWeight() >= 0);
 
 		if (Settings::ShowEnchanted()) {
-			value.SetMember("enchanted", { IsEnchanted() });
-			value.SetMember("knownEnchanted", { IsKnownEnchanted() });
-			value.SetMember("specialEnchanted", { IsSpecialEnchanted() });
+			set(kRowEnchanted, IsEnchanted());
+			set(kRowKnownEnchanted, IsKnownEnchanted());
+			set(kRowSpecialEnchanted, IsSpecialEnchanted());
 		}
 
 		if (Settings::ShowDBMNew())
-			value.SetMember("dbmNew", { ItemIsNew() });
+			set(kRowDBMNew, ItemIsNew());
 
 		if (Settings::ShowDBMFound())
-			value.SetMember("dbmFound", { ItemIsFound() });
+			set(kRowDBMFound, ItemIsFound());
 
 		if (Settings::ShowDBMDisplayed())
-			value.SetMember("dbmDisp", { ItemIsDisplayed() });
+			set(kRowDBMDisplayed, ItemIsDisplayed());
 
 		if (Settings::ShowBookRead())
-			value.SetMember("isRead", { IsRead() });
+			set(kRowRead, IsRead());
+
+		return flags;
+	}
+
+	std::uint32_t GFxItem::GetTraits() const
+	{
+		std::uint32_t traits = 0;
+		traits |= IsStolen() ? kTraitStolen : 0;
+		traits |= IsQuestItem() ? kTraitQuestItem : 0;
+		traits |= IsBook() && IsRead() ? kTraitReadBook : 0;
+		traits |= IsKnownEnchanted() ? kTraitKnownEnchantment : 0;
+		return traits;
+	}
 
-		return value;
+	std::span<const char* const> GFxItem::GetIconLabels()
+	{
+		return { std::begin(strIcons), std::end(strIcons) };
 	}
 
 	static kType GetItemTypeWeapon(TESObjectWEAP* weap)
@@ -1028,7 +1068,17 @@ namespace Items
 
 		return type;
 	}
-	kType GFxItem::GetItemType(TESForm* form) const
+	kType GFxItem::GetItemType(TESForm* a_form)
+	{
+		if (!a_form) {
+			return kType::None;
+		}
+
+		const auto record = ClassCache::Find(a_form->GetFormID());
+		return record && (record->flags & ClassCache::kTyped) != 0 ? static_cast<kType>(record->type) : ComputeItemType(a_form);
+	}
+
+	kType GFxItem::ComputeItemType(TESForm* form)
 	{
 		kType type = kType::None;
 
@@ -1093,37 +1143,17 @@ namespace Items
 		return false;
 	}
 
-	EnchantmentType GFxItem::GetEnchantmentType() const
+	// The keyword tests, which hold for the whole session. The known tests are left to the main thread:
+	// a known enchantment, or else a known base enchantment, turns the row Known
+	void GFxItem::ClassifyEnchantment(const ClassifyInput& a_input, Classification& a_class)
 	{
-		EnchantmentType result = EnchantmentType::None;
-		const RE::InventoryEntryData* item_inventory_entry = nullptr;
-		const RE::TESForm* item_form = nullptr;
-		RE::TESObjectREFR* item_refr = nullptr;
-
-		switch (_src.index()) {
-		case kInventory:
-		{
-			item_inventory_entry = std::get<kInventory>(_src);
-			item_form = item_inventory_entry ? item_inventory_entry->GetObject() : nullptr;
-			break;
-		}
-		case kGround:
-		{
-			for (const auto& handle : std::get<kGround>(_src)) {
-				if (!handle.get())
-					continue;
-				item_refr = handle.get().get();
-				item_form = item_refr;
-			}
-			break;
-		}
-		default:
-			assert(false);
-		};
+		a_class.enchantment = EnchantmentType::None;
+		a_class.knownBy = {};
+		const RE::TESForm* item_form = a_input.object;
 
 		if (!item_form) 
 		{
-			return result;
+			return;
 		}
 
 		const auto item_form_type = item_form->GetFormType();
@@ -1133,7 +1163,7 @@ namespace Items
 			&& item_form_type != RE::FormType::Ammo 
 			&& item_form_type != RE::FormType::Projectile)
 		{
-			return result;
+			return;
 		}
 
 		RE::EnchantmentItem* enchantment = nullptr;
@@ -1145,67 +1175,108 @@ namespace Items
 			enchantment = enchantable->formEnchanting;
 		}
 
-		if (item_refr) {
-			if (auto extraEnchant = static_cast<RE::ExtraEnchantment*>(item_refr->extraList.GetByType(RE::ExtraDataType::kEnchantment))) {
-				wasExtra = true;
-				enchantment = extraEnchant->enchantment;
-			}
+		if (a_input.hasExtraEnchantment) {
+			wasExtra = true;
+			enchantment = a_input.extraEnchantment;
 		}
 
 		if (enchantment) {
-			// It has an enchantment be it may not be known.
-			result = EnchantmentType::Unknown;
-
-			if ((enchantment->formFlags & RE::TESForm::RecordFlags::kKnown) == RE::TESForm::RecordFlags::kKnown) {
-				return MagicDisallowEnchanting(enchantment) ? EnchantmentType::CannotDisenchant : EnchantmentType::Known;
-			} 
-			
 			if (MagicDisallowEnchanting(enchantment)) {
-				return EnchantmentType::CannotDisenchant;
-			} 
-			
+				a_class.enchantment = EnchantmentType::CannotDisenchant;
+				return;
+			}
+			a_class.knownBy[0] = enchantment;
+
 			auto baseEnchantment = static_cast<RE::EnchantmentItem*>(enchantment->data.baseEnchantment);
-			if (baseEnchantment) {
-				if ((baseEnchantment->formFlags & RE::TESForm::RecordFlags::kKnown) == RE::TESForm::RecordFlags::kKnown) {
-					return MagicDisallowEnchanting(baseEnchantment) ? EnchantmentType::CannotDisenchant : EnchantmentType::Known;
-				} 
-				
-				if (MagicDisallowEnchanting(baseEnchantment)) {
-					return EnchantmentType::CannotDisenchant;
-				}
+			if (baseEnchantment && MagicDisallowEnchanting(baseEnchantment)) {
+				a_class.enchantment = EnchantmentType::CannotDisenchant;
+				return;
 			}
+			a_class.knownBy[1] = baseEnchantment;
 		}
 
 		// Its safe to assume that if it not a base enchanted item, that it was enchanted by the player and therefore, they
 		// know the enchantment
 		if (wasExtra) {
-			return EnchantmentType::Known;
-		} 
-		
-		if (enchantable) {
-			return MagicDisallowEnchanting(keyWordForm) ? EnchantmentType::CannotDisenchant : result;
+			a_class.enchantment = EnchantmentType::Known;
+		} else if (enchantable && MagicDisallowEnchanting(keyWordForm)) {
+			a_class.enchantment = EnchantmentType::CannotDisenchant;
+		} else {
+			a_class.enchantment = enchantment ? EnchantmentType::Unknown : EnchantmentType::None;
 		}
+	}
 
-		return result;
+	// Main thread only, learning an enchantment sets its kKnown flag
+	EnchantmentType GFxItem::GetEnchantmentType(const Classification& a_class)
+	{
+		for (const auto enchantment : a_class.knownBy) {
+			if (enchantment && (enchantment->formFlags & RE::TESForm::RecordFlags::kKnown) == RE::TESForm::RecordFlags::kKnown) {
+				return EnchantmentType::Known;
+			}
+		}
+		return a_class.enchantment;
 	}
 
-	// Almost straight up copied from MoreHudSE. Had to change some things to work with this. https://github.com/ahzaab/moreHUDSE
-	void GFxItem::SetupEnchantmentFlags() const
+	EnchantmentType GFxItem::GetEnchantmentType() const
 	{
-		EnchantmentType ench_type = GetEnchantmentType();
+		Classification result;
+		ClassifyEnchantment(Snapshot(), result);
+		return GetEnchantmentType(result);
+	}
 
+	// Almost straight up copied from MoreHudSE. Had to change some things to work with this. https://github.com/ahzaab/moreHUDSE
+	void GFxItem::SetEnchantmentFlags(EnchantmentType ench_type) const
+	{
 		_cache.IsEnchanted(ench_type != EnchantmentType::None);
 		_cache.IsKnownEnchanted(ench_type == EnchantmentType::Known);
 		_cache.IsSpecialEnchanted(ench_type == EnchantmentType::CannotDisenchant);
 	}
 
-	const char* GFxItem::GetItemIconLabel(kType form) const
+	// Resolves everything Classify reads, ground handles included, so it never has to touch a ref
+	ClassifyInput GFxItem::Snapshot() const
+	{
+		ClassifyInput result;
+		switch (_src.index()) {
+		case kInventory:
+			result.object = std::get<kInventory>(_src).object;
+			break;
+		case kGround:
+			for (const auto& handle : std::get<kGround>(_src)) {
+				const auto item = handle.get();
+				if (!item) {
+					continue;
+				}
+
+				if (!result.object) {
+					result.object = item->GetObjectReference();
+				}
+
+				// The last ref found decides the enchantment, as it always did. Its base object is
+				// classified, the ref itself may unload before a worker gets to it
+				const auto xEnch = item->extraList.GetByType<RE::ExtraEnchantment>();
+				result.extraEnchantment = xEnch ? xEnch->enchantment : nullptr;
+				result.hasExtraEnchantment = xEnch != nullptr;
+			}
+			break;
+		default:
+			assert(false);
+			break;
+		}
+		return result;
+	}
+
+	Classification GFxItem::Classify(const ClassifyInput& a_input)
 	{
-		size_t form_num = static_cast<size_t>(form);
-		if (form_num < sizeof(strIcons) / sizeof(strIcons[0]))
-			return strIcons[form_num];
+		Classification result;
+		result.type = GetItemType(a_input.object);
+		ClassifyEnchantment(a_input, result);
+		return result;
+	}
 
-		return strIcons[0];
+	void GFxItem::Prime(const Classification& a_class)
+	{
+		_cache.ItemType(a_class.type);
+		SetEnchantmentFlags(GetEnchantmentType(a_class));
 	}
 }
 
@@ -137,15 +137,57 @@ namespace Items
 	};
 
 
+	// Bits of the packed flags column, keep in sync with LootMenu.PackedDataProvider
+	enum RowFlag : std::uint32_t
+	{
+		kRowStolen = 1 << 0,
+		kRowEnchanted = 1 << 1,
+		kRowKnownEnchanted = 1 << 2,
+		kRowSpecialEnchanted = 1 << 3,
+		kRowRead = 1 << 4,
+		kRowDBMNew = 1 << 5,
+		kRowDBMFound = 1 << 6,
+		kRowDBMDisplayed = 1 << 7,
+		kRowHasWeight = 1 << 8
+	};
+
+	// Raw item properties the row filter tests, independent of the icon settings
+	enum Trait : std::uint32_t
+	{
+		kTraitStolen = 1 << 0,
+		kTraitQuestItem = 1 << 1,
+		kTraitReadBook = 1 << 2,
+		kTraitKnownEnchantment = 1 << 3
+	};
+
+	// The form data a row's classification reads, captured on the main thread. Only base objects and
+	// enchantments are kept, never refs, so the classification itself can run on any thread.
+	struct ClassifyInput
+	{
+		RE::TESBoundObject* object{ nullptr };
+		RE::EnchantmentItem* extraEnchantment{ nullptr };
+		bool hasExtraEnchantment{ false };
+	};
+
+	// Whether the player knows an enchantment changes during play, Prime reads it on the main thread
+	struct Classification
+	{
+		kType type{ kType::None };
+		EnchantmentType enchantment{ EnchantmentType::None };  // unless one of knownBy is known
+		std::array<const RE::EnchantmentItem*, 2> knownBy{};
+	};
+
 	class GFxItem
 	{
 	public:
 
-		GFxItem(std::ptrdiff_t a_count, bool a_stealing, SKSE::stl::observer<RE::InventoryEntryData*> a_item);
-		GFxItem(std::ptrdiff_t a_count, bool a_stealing, std::span<const RE::ObjectRefHandle> a_items);
+		GFxItem(std::ptrdiff_t a_count, bool a_stealing, SKSE::stl::observer<RE::TESBoundObject*> a_object, RE::ObjectRefHandle a_container, std::pmr::memory_resource& a_arena);
+		GFxItem(std::ptrdiff_t a_count, bool a_stealing, std::span<const RE::ObjectRefHandle> a_items, std::pmr::memory_resource& a_arena);
 		[[nodiscard]] constexpr std::ptrdiff_t Count() const noexcept { return _count; }
-		[[nodiscard]] int                      Compare(const GFxItem& a_rhs) const;
-		[[nodiscard]] const std::string&       GetDisplayName() const;
+		void                                   SetCount(std::ptrdiff_t a_count);
+		[[nodiscard]] constexpr bool           InContainer() const noexcept { return _src.index() == kInventory; }
+		[[nodiscard]] std::uint8_t             GetSortRank() const;
+		[[nodiscard]] std::string_view         GetDisplayName() const;
 		[[nodiscard]] double                   GetEnchantmentCharge() const;
 		[[nodiscard]] bool                     IsEnchanted() const;
 		[[nodiscard]] bool                     IsKnownEnchanted() const;
@@ -166,34 +208,51 @@ namespace Items
 		[[nodiscard]] bool                     ItemIsNew() const;
 		[[nodiscard]] bool                     ItemIsFound() const;
 		[[nodiscard]] bool                     ItemIsDisplayed() const;
-		[[nodiscard]] RE::GFxValue             GFxValue(RE::GFxMovieView& a_view) const;
+		[[nodiscard]] std::uint32_t            GetIconIndex() const;
+		[[nodiscard]] std::uint32_t            GetRowFlags() const;
+		[[nodiscard]] std::uint32_t            GetTraits() const;
+
+		[[nodiscard]] ClassifyInput            Snapshot() const;
+		[[nodiscard]] static Classification    Classify(const ClassifyInput& a_input);
+		void                                   Prime(const Classification& a_class);
+
+		[[nodiscard]] static std::span<const char* const> GetIconLabels();
 
 	private:
-		EnchantmentType GetEnchantmentType() const;
-		void SetupEnchantmentFlags() const;
+		static void ClassifyEnchantment(const ClassifyInput& a_input, Classification& a_class);
+		[[nodiscard]] static EnchantmentType GetEnchantmentType(const Classification& a_class);
+		[[nodiscard]] EnchantmentType GetEnchantmentType() const;
+		[[nodiscard]] static kType GetItemType(RE::TESForm* a_form);
+
+		// The uncached rule, which ClassCache persists for the types that don't depend on keywords
+		[[nodiscard]] static kType ComputeItemType(RE::TESForm* a_form);
 
-		kType GetItemType(RE::TESForm *form) const;
-		const char* GetItemIconLabel(kType type) const;
+		friend class ClassCache;
+
+		void SetEnchantmentFlags(EnchantmentType a_type) const;
+
+		template <class Fn>
+		decltype(auto) WithEntry(Fn&& a_fn) const;
 
 		class Cache;
 
 		#include "GFxItemCache.hpp"
 
-		using inventory_t = RE::InventoryEntryData*;
+		// Rows keep no entry of their own, the live one is looked up in the container when read
+		struct inventory_t
+		{
+			RE::TESBoundObject* object;
+			RE::ObjectRefHandle container;
+		};
+
 		using ground_t = std::span<const RE::ObjectRefHandle>;
 
 		std::variant<inventory_t, ground_t> _src;
+		stl::observer<std::pmr::memory_resource*> _arena;
 		std::ptrdiff_t _count;
 		mutable Cache _cache;
 		bool _stealing;
 		kType _item_type;
 	};
-
-	[[nodiscard]] inline bool operator==(const GFxItem& a_lhs, const GFxItem& a_rhs) { return a_lhs.Compare(a_rhs) == 0; }
-	[[nodiscard]] inline bool operator!=(const GFxItem& a_lhs, const GFxItem& a_rhs) { return a_lhs.Compare(a_rhs) != 0; }
-	[[nodiscard]] inline bool operator< (const GFxItem& a_lhs, const GFxItem& a_rhs) { return a_lhs.Compare(a_rhs) <  0; }
-	[[nodiscard]] inline bool operator> (const GFxItem& a_lhs, const GFxItem& a_rhs) { return a_lhs.Compare(a_rhs) >  0; }
-	[[nodiscard]] inline bool operator<=(const GFxItem& a_lhs, const GFxItem& a_rhs) { return a_lhs.Compare(a_rhs) <= 0; }
-	[[nodiscard]] inline bool operator>=(const GFxItem& a_lhs, const GFxItem& a_rhs) { return a_lhs.Compare(a_rhs) >= 0; }
 }
 
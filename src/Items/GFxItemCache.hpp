@@ -38,6 +38,8 @@ class Cache
 public:
 	[[nodiscard]] bool operator[](std::size_t a_flag) const { return _cached.test(a_flag); }
 
+	void Invalidate(std::size_t a_flag) { _cached.reset(a_flag); }
+
 	[[nodiscard]] bool QuestItem() const { return _flags.test(kQuestItem); }
 	void QuestItem(bool a_value) { CacheFlag(kQuestItem, a_value); }
 
@@ -83,11 +85,11 @@ public:
 	[[nodiscard]] double IsDBMDisplayed() const noexcept { return _flags.test(kIsDBMDisplayed); }
 	void IsDBMDisplayed(bool a_value) { CacheFlag(kIsDBMDisplayed, a_value); }
 
-	[[nodiscard]] constexpr const std::string& DisplayName() const noexcept { return _displayName; }
-	void DisplayName(std::string a_value)
+	[[nodiscard]] constexpr std::string_view DisplayName() const noexcept { return _displayName; }
+	void DisplayName(std::string_view a_value)
 	{
 		_cached.set(kDisplayName);
-		_displayName = std::move(a_value);
+		_displayName = a_value;
 	}
 
 	[[nodiscard]] constexpr double EnchantmentCharge() const noexcept { return _enchantmentCharge; }
@@ -135,7 +137,7 @@ private:
 	std::bitset<kTotalFlags>       _flags;
 	std::bitset<kTotalCachedFlags> _cached;
 
-	std::string                    _displayName       = "";
+	std::string_view               _displayName       = ""sv;
 	double                         _enchantmentCharge = -1.0;
 	double                         _weight            = 0.0;
 	std::ptrdiff_t                 _value             = 0;
@@ -15,8 +15,8 @@ namespace Items
 		GroundItems(const GroundItems&) = delete;
 		GroundItems(GroundItems&&) = default;
 
-		 GroundItems(std::ptrdiff_t a_count, bool a_stealing, std::vector<RE::ObjectRefHandle> a_items) :
-			super(a_count, a_stealing, { a_items.data(), a_items.size() }),
+		GroundItems(std::ptrdiff_t a_count, bool a_stealing, std::pmr::vector<RE::ObjectRefHandle> a_items, std::pmr::memory_resource& a_arena) :
+			super(a_count, a_stealing, { a_items.data(), a_items.size() }, a_arena),
 			_items(std::move(a_items))
 		{}
 
@@ -26,7 +26,7 @@ namespace Items
 		GroundItems& operator=(GroundItems&&) = default;
 
 	protected:
-		 void DoTake(RE::Actor& a_dst, std::ptrdiff_t a_count) override
+		 void DoTake(TakeTransaction& a_txn, std::ptrdiff_t a_count) override
 		{
 			auto toRemove = std::clamp<std::ptrdiff_t>(a_count, 0, Count());
 			if (toRemove <= 0) {
@@ -38,7 +38,7 @@ namespace Items
 				auto item = handle.get();
 				if (item) {
 					const auto xCount = std::clamp<std::ptrdiff_t>(item->extraList.GetCount(), 1, toRemove);
-					a_dst.PickUpObject(item.get(), static_cast<std::int32_t>(xCount), false, true);
+					a_txn.QueuePickUp(*item, static_cast<std::int32_t>(xCount));
 					toRemove -= xCount;
 
 					if (toRemove <= 0) {
@@ -49,6 +49,6 @@ namespace Items
 		}
 
 	private:
-		std::vector<RE::ObjectRefHandle> _items;
+		std::pmr::vector<RE::ObjectRefHandle> _items;
 	};
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Items/InventoryView.h"
 #include "Items/Item.h"
 
 namespace Items
@@ -15,13 +16,12 @@ namespace Items
 		InventoryItem(const InventoryItem&) = delete;
 		InventoryItem(InventoryItem&&) = default;
 
-		InventoryItem(std::ptrdiff_t a_count, bool a_stealing, std::unique_ptr<RE::InventoryEntryData> a_item, RE::ObjectRefHandle a_container) :
-			super(a_count, a_stealing, a_item.get()),
-			_entry(std::move(a_item)),
+		// The game frees or replaces its entries as stacks change, the row looks its entry up when it needs one
+		InventoryItem(std::ptrdiff_t a_count, bool a_stealing, RE::TESBoundObject& a_object, RE::ObjectRefHandle a_container, std::pmr::memory_resource& a_arena) :
+			super(a_count, a_stealing, std::addressof(a_object), a_container, a_arena),
+			_object(std::addressof(a_object)),
 			_container(a_container)
 		{
-			assert(_entry != nullptr);
-			assert(_entry->GetObject() != nullptr);
 			assert(_container);
 		}
 
@@ -31,45 +31,52 @@ namespace Items
 		InventoryItem& operator=(InventoryItem&&) = default;
 
 	protected:
-		void DoTake(RE::Actor& a_dst, std::ptrdiff_t a_count) override
+		void DoTake(TakeTransaction& a_txn, std::ptrdiff_t a_count) override
 		{
-			auto container = _container.get();
+			auto container = a_txn.Container(_container);
 			if (!container) {
 				assert(false);
 				return;
 			}
 
-			const auto [leftover, queued] = GetItemsToRemove(a_count);
-
-			const auto object = _entry->GetObject();
-			a_dst.PlayPickUpSound(object, true, false);
-			TryRemoveArrows3D(*container, *object);
-			const auto remove =
-				[&](std::int32_t a_num, RE::ExtraDataList* a_extraList, RE::ITEM_REMOVE_REASON a_reason) {
-					container->RemoveItem(object, a_num, a_reason, a_extraList, std::addressof(a_dst));
-					auto& player = static_cast<RE::PlayerCharacter&>(a_dst);
-					player.PlayPickupEvent(object, container->GetOwner(), container.get(), RE::PlayerCharacter::EventType::kContainer);
-				};
-
-			std::function action =
-				[&](std::int32_t a_num, RE::ExtraDataList* a_extraList) {
-					remove(a_num, a_extraList, RE::ITEM_REMOVE_REASON::kRemove);
-				};
-			if (Stolen()) {
-				action =
-					[&](std::int32_t a_num, RE::ExtraDataList* a_extraList) {
-						remove(a_num, a_extraList, RE::ITEM_REMOVE_REASON::kSteal);
-						a_dst.StealAlarm(container.get(), object, a_num, static_cast<std::int32_t>(Value()), container->GetOwner(), true);
-					};
-			}
+			const auto [leftover, queued] = GetItemsToRemove(InventoryView::LookupEntry(*container, *_object), a_count);
+			TryRemoveArrows3D(*container, *_object);
 
+			const auto stolen = Stolen();
+			std::ptrdiff_t total = 0;
 			for (const auto& [xList, count] : queued) {
-				action(static_cast<std::int32_t>(count), xList);
+				a_txn.QueueRemove(*container, *_object, static_cast<std::int32_t>(count), xList, stolen);
+				total += count;
 			}
 
 			if (leftover > 0) {
-				action(static_cast<std::int32_t>(leftover), nullptr);
+				a_txn.QueueRemove(*container, *_object, static_cast<std::int32_t>(leftover), nullptr, stolen);
+				total += leftover;
+			}
+
+			if (stolen && total > 0) {
+				const auto unitValue = Count() > 0 ? Value() / Count() : 0;
+				a_txn.AddStolen(*container, *_object, static_cast<std::int32_t>(total), static_cast<std::int32_t>(unitValue));
+			}
+		}
+
+		bool DoApplyCountDelta(std::ptrdiff_t a_delta) override
+		{
+			// Without knowing which extra list changed, only whole stacks can be patched in place. An
+			// emptied stack is left to the rescan, which drops its row
+			const auto count = Count() + a_delta;
+			if (count <= 0) {
+				return false;
 			}
+
+			const auto container = _container.get();
+			const auto entry = container ? InventoryView::LookupEntry(*container, *_object) : nullptr;
+			if (!container || (entry && entry->extraLists && !entry->extraLists->empty())) {
+				return false;
+			}
+
+			SetCount(count);
+			return true;
 		}
 
 	private:
@@ -81,13 +88,13 @@ namespace Items
 			}
 		}
 
-		auto GetItemsToRemove(std::ptrdiff_t a_count)
+		auto GetItemsToRemove(const RE::InventoryEntryData* a_entry, std::ptrdiff_t a_count)
 			-> std::pair<std::ptrdiff_t, std::vector<std::pair<RE::ExtraDataList*, std::ptrdiff_t>>>
 		{
 			std::vector<std::pair<RE::ExtraDataList*, std::ptrdiff_t>> queued;
 			auto toRemove = std::clamp<std::ptrdiff_t>(a_count, 0, Count());
-			if (toRemove > 0 && _entry->extraLists) {
-				for (auto& xList : *_entry->extraLists) {
+			if (toRemove > 0 && a_entry && a_entry->extraLists) {
+				for (auto& xList : *a_entry->extraLists) {
 					if (xList) {
 						const auto xCount = std::clamp<std::ptrdiff_t>(xList->GetCount(), 1, toRemove);
 						toRemove -= xCount;
@@ -103,7 +110,7 @@ namespace Items
 			return { toRemove, std::move(queued) };
 		}
 
-		std::unique_ptr<RE::InventoryEntryData> _entry;
+		RE::TESBoundObject* _object;
 		RE::ObjectRefHandle _container;
 	};
 }
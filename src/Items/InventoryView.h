@@ -0,0 +1,93 @@
+#pragma once
+
+namespace Items
+{
+	// Walks a reference's inventory in place: the base container merged with its InventoryChanges, each
+	// object yielded once with its net count. Unlike TESObjectREFR::GetInventory nothing is copied,
+	// the changes entries stay owned by the game and no map is built.
+	class InventoryView
+	{
+	public:
+		struct Entry
+		{
+			RE::TESBoundObject* object;
+			std::int32_t count;
+			RE::InventoryEntryData* changes;  // nullptr when only the base container holds the object
+		};
+
+		template <class Filter, class Fn>
+		void ForEach(RE::TESObjectREFR& a_ref, Filter&& a_filter, Fn&& a_fn)
+		{
+			_base.clear();
+			if (const auto container = a_ref.GetContainer(); container) {
+				container->ForEachContainerObject([&](RE::ContainerObject& a_entry) {
+					const auto object = a_entry.obj;
+					if (object && a_filter(*object)) {
+						const auto it = Find(object);
+						if (it != _base.end()) {
+							it->second += a_entry.count;
+						} else {
+							_base.emplace_back(object, a_entry.count);
+						}
+					}
+					return RE::BSContainer::ForEachResult::kContinue;
+				});
+			}
+
+			const auto changes = a_ref.GetInventoryChanges();
+			if (changes && changes->entryList) {
+				for (const auto entry : *changes->entryList) {
+					if (!entry || !entry->object || !a_filter(*entry->object)) {
+						continue;
+					}
+
+					// A leveled entry already holds the resolved base count, like GetInventory
+					auto count = entry->countDelta;
+					if (const auto it = Find(entry->object); it != _base.end()) {
+						if (!entry->IsLeveled()) {
+							count += it->second;
+						}
+						it->first = nullptr;
+					}
+
+					a_fn(Entry{ entry->object, count, entry });
+				}
+			}
+
+			for (const auto& [object, count] : _base) {
+				if (object) {
+					a_fn(Entry{ object, count, nullptr });
+				}
+			}
+		}
+
+		// The live changes entry for a_object, nullptr when only the base container holds it. The game
+		// frees and replaces entries as stacks change, so callers look it up again rather than keep it
+		[[nodiscard]] static RE::InventoryEntryData* LookupEntry(RE::TESObjectREFR& a_ref, const RE::TESBoundObject& a_object)
+		{
+			const auto changes = a_ref.GetInventoryChanges();
+			if (changes && changes->entryList) {
+				for (const auto entry : *changes->entryList) {
+					if (entry && entry->object == std::addressof(a_object)) {
+						return entry;
+					}
+				}
+			}
+
+			return nullptr;
+		}
+
+	private:
+		using base_t = std::vector<std::pair<RE::TESBoundObject*, std::int32_t>>;
+
+		// Base containers hold a handful of objects, a linear scan beats hashing them
+		[[nodiscard]] base_t::iterator Find(const RE::TESBoundObject* a_object)
+		{
+			return std::find_if(_base.begin(), _base.end(), [&](auto&& a_elem) {
+				return a_elem.first == a_object;
+			});
+		}
+
+		base_t _base;
+	};
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Items/GFxItem.h"
+#include "Items/ItemArena.h"
+#include "Items/TakeTransaction.h"
 
 namespace Items
 {
@@ -11,12 +13,12 @@ namespace Items
 		Item(const Item&) = delete;
 		Item(Item&&) = default;
 
-		Item(std::ptrdiff_t a_count, bool a_stealing, stl::observer<RE::InventoryEntryData*> a_item) :
-			_item(a_count, a_stealing, a_item)
+		Item(std::ptrdiff_t a_count, bool a_stealing, stl::observer<RE::TESBoundObject*> a_object, RE::ObjectRefHandle a_container, std::pmr::memory_resource& a_arena) :
+			_item(a_count, a_stealing, a_object, a_container, a_arena)
 		{}
 
-		Item(std::ptrdiff_t a_count, bool a_stealing, std::span<const RE::ObjectRefHandle> a_items) :
-			_item(a_count, a_stealing, a_items)
+		Item(std::ptrdiff_t a_count, bool a_stealing, std::span<const RE::ObjectRefHandle> a_items, std::pmr::memory_resource& a_arena) :
+			_item(a_count, a_stealing, a_items, a_arena)
 		{}
 
 		virtual ~Item() = default;
@@ -24,32 +26,47 @@ namespace Items
 		Item& operator=(const Item&) = delete;
 		Item& operator=(Item&&) = default;
 
-		[[nodiscard]] int Compare(const Item& a_rhs) const { return _item.Compare(a_rhs._item); }
+		[[nodiscard]] std::string_view DisplayName() const { return _item.GetDisplayName(); }
+		[[nodiscard]] std::uint32_t IconIndex() const { return _item.GetIconIndex(); }
+		[[nodiscard]] std::uint32_t RowFlags() const { return _item.GetRowFlags(); }
+		[[nodiscard]] std::uint8_t SortRank() const { return _item.GetSortRank(); }
+		[[nodiscard]] std::uint32_t Traits() const { return _item.GetTraits(); }
+		[[nodiscard]] kType ItemType() const { return _item.GetItemType(); }
 
-		[[nodiscard]] RE::GFxValue GFxValue(RE::GFxMovieView& a_view) const { return _item.GFxValue(a_view); }
+		[[nodiscard]] ClassifyInput Snapshot() const { return _item.Snapshot(); }
+		void Prime(const Classification& a_class) { _item.Prime(a_class); }
 
-		void Take(RE::Actor& a_dst, std::ptrdiff_t a_count) { DoTake(a_dst, a_count); }
-		void Take(RE::Actor& a_dst) { DoTake(a_dst, 1); }
-		void TakeAll(RE::Actor& a_dst) { DoTake(a_dst, Count()); }
+		void Take(RE::Actor& a_dst, std::ptrdiff_t a_count)
+		{
+			TakeTransaction txn{ a_dst };
+			DoTake(txn, a_count);
+		}
+
+		void Take(RE::Actor& a_dst) { Take(a_dst, 1); }
+		void TakeAll(RE::Actor& a_dst) { Take(a_dst, Count()); }
+
+		void Take(TakeTransaction& a_txn, std::ptrdiff_t a_count) { DoTake(a_txn, a_count); }
+		void TakeAll(TakeTransaction& a_txn) { DoTake(a_txn, Count()); }
+
+		// Returns false when the change can't be applied without rescanning the container
+		[[nodiscard]] bool ApplyCountDelta(std::ptrdiff_t a_delta) { return DoApplyCountDelta(a_delta); }
+
+		[[nodiscard]] std::ptrdiff_t Count() const { return std::max<std::ptrdiff_t>(_item.Count(), 0); }
+		[[nodiscard]] RE::FormID FormID() const { return _item.GetFormID(); }
+		[[nodiscard]] bool InContainer() const { return _item.InContainer(); }
 
 		[[nodiscard]] double EnchantmentCharge() const { return _item.GetEnchantmentCharge(); }
 		[[nodiscard]] std::ptrdiff_t Value() const { return _item.GetValue(); }
 		[[nodiscard]] double Weight() const { return _item.GetWeight(); }
 
 	protected:
-		virtual void DoTake(RE::Actor& a_dst, std::ptrdiff_t a_count) = 0;
+		virtual void DoTake(TakeTransaction& a_txn, std::ptrdiff_t a_count) = 0;
+		virtual bool DoApplyCountDelta(std::ptrdiff_t) { return false; }
 
-		[[nodiscard]] std::ptrdiff_t Count() const { return std::max<std::ptrdiff_t>(_item.Count(), 0); }
+		void SetCount(std::ptrdiff_t a_count) { _item.SetCount(a_count); }
 		[[nodiscard]] bool Stolen() const { return _item.IsStolen(); }
 
 	private:
 		GFxItem _item;
 	};
-
-	[[nodiscard]] inline bool operator==(const Item& a_lhs, const Item& a_rhs) { return a_lhs.Compare(a_rhs) == 0; }
-	[[nodiscard]] inline bool operator!=(const Item& a_lhs, const Item& a_rhs) { return a_lhs.Compare(a_rhs) != 0; }
-	[[nodiscard]] inline bool operator<(const Item& a_lhs, const Item& a_rhs) { return a_lhs.Compare(a_rhs) < 0; }
-	[[nodiscard]] inline bool operator>(const Item& a_lhs, const Item& a_rhs) { return a_lhs.Compare(a_rhs) > 0; }
-	[[nodiscard]] inline bool operator<=(const Item& a_lhs, const Item& a_rhs) { return a_lhs.Compare(a_rhs) <= 0; }
-	[[nodiscard]] inline bool operator>=(const Item& a_lhs, const Item& a_rhs) { return a_lhs.Compare(a_rhs) >= 0; }
 }
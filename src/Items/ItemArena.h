@@ -0,0 +1,86 @@
+#pragma once
+
+namespace Items
+{
+	class Item;
+
+	// Arena objects are never freed one by one, the owner only runs their destructors
+	struct ArenaDeleter
+	{
+		template <class T>
+		void operator()(T* a_ptr) const noexcept
+		{
+			std::destroy_at(a_ptr);
+		}
+	};
+
+	template <class T>
+	using arena_ptr = std::unique_ptr<T, ArenaDeleter>;
+
+	using ItemPtr = arena_ptr<Item>;
+
+	// Backing storage for the item model of one refresh. Everything the model allocates (the items,
+	// their entry data, ground handles and display names) comes from here, and the whole refresh is
+	// released in one step by Reset.
+	class ItemArena
+	{
+	public:
+		ItemArena() :
+			_buffer(std::make_unique<std::byte[]>(INITIAL_SIZE)),
+			_resource(_buffer.get(), INITIAL_SIZE)
+		{}
+
+		ItemArena(const ItemArena&) = delete;
+		ItemArena(ItemArena&&) = delete;
+
+		~ItemArena() = default;
+
+		ItemArena& operator=(const ItemArena&) = delete;
+		ItemArena& operator=(ItemArena&&) = delete;
+
+		[[nodiscard]] std::pmr::memory_resource* Resource() noexcept { return std::addressof(_resource); }
+
+		template <class T, class... Args>
+		[[nodiscard]] arena_ptr<T> Make(Args&&... a_args)
+		{
+			std::pmr::polymorphic_allocator<> alloc{ Resource() };
+			return arena_ptr<T>{ alloc.new_object<T>(std::forward<Args>(a_args)...) };
+		}
+
+		// Copies the string with a terminator so the view can still be handed to C APIs
+		[[nodiscard]] static std::string_view Intern(std::pmr::memory_resource& a_resource, std::string_view a_str)
+		{
+			const auto data = static_cast<char*>(a_resource.allocate(a_str.size() + 1, alignof(char)));
+			std::copy(a_str.begin(), a_str.end(), data);
+			data[a_str.size()] = '\0';
+			return { data, a_str.size() };
+		}
+
+		// Every object allocated from the arena must already be destroyed
+		void Reset() { _resource.release(); }
+
+	private:
+		static constexpr std::size_t INITIAL_SIZE{ 1 << 16 };
+
+		std::unique_ptr<std::byte[]> _buffer;
+		std::pmr::monotonic_buffer_resource _resource;
+	};
+
+	// Double buffered so a refresh can build the next model while the current one is still displayed
+	class ItemArenas
+	{
+	public:
+		[[nodiscard]] ItemArena& Back() noexcept { return _arenas[_front ^ 1]; }
+
+		// Call once the old model has been destroyed, the previous front is recycled by the next refresh
+		void Swap()
+		{
+			_arenas[_front].Reset();
+			_front ^= 1;
+		}
+
+	private:
+		std::array<ItemArena, 2> _arenas;
+		std::size_t _front{ 0 };
+	};
+}
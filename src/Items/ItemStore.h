@@ -0,0 +1,290 @@
+#pragma once
+
+#include "Items/AcquisitionLog.h"
+#include "Items/Collation.h"
+#include "Items/Item.h"
+#include "Items/RadixSort.h"
+
+namespace Items
+{
+	enum class SortMode : std::uint32_t
+	{
+		kDefault,  // categories, then value, then name
+		kValue,
+		kWeight,  // lightest first
+		kValuePerWeight,
+		kName,
+		kType,
+		kRecent,  // most recently put in the container first
+		kTotal
+	};
+
+	// Column store of the displayed rows. The items stay behind as take adapters, everything the menu
+	// sorts, scans or sends to the SWF is read from here instead of through the items' virtual getters.
+	// Rows keep their build order, positions index the display order in _order.
+	class ItemStore
+	{
+	public:
+		static constexpr std::uint32_t kInContainer{ 1u << 31 };  // masked out of RowFlags, kept in Flags
+
+		void Assign(std::span<const ItemPtr> a_items, RE::FormID a_container)
+		{
+			Clear();
+
+			const auto size = a_items.size();
+			_formID.reserve(size);
+			_value.reserve(size);
+			_weight.reserve(size);
+			_count.reserve(size);
+			_flags.reserve(size);
+			_traits.reserve(size);
+			_rank.reserve(size);
+			_type.reserve(size);
+			_recent.reserve(size);
+			_icon.reserve(size);
+			_nameOffset.reserve(size);
+			_foldedOffset.reserve(size);
+			_keyOffset.reserve(size);
+			_source.reserve(size);
+			_order.reserve(size);
+
+			const auto log = AcquisitionLog::GetSingleton();
+			for (std::uint32_t i = 0; i < size; ++i) {
+				const auto& item = *a_items[i];
+				_formID.push_back(item.FormID());
+				_traits.push_back(item.Traits());
+				_rank.push_back(item.SortRank());
+				_type.push_back(static_cast<std::uint16_t>(item.ItemType()));
+				_recent.push_back(item.InContainer() ? log->Stamp(a_container, item.FormID()) : 0);
+				_icon.push_back(item.IconIndex());
+				_nameOffset.push_back(Intern(item.DisplayName()));
+				_foldedOffset.push_back(InternFolded(item.DisplayName()));
+				_keyOffset.push_back(InternKey(item.DisplayName()));
+				_source.push_back(i);
+				_order.push_back(i);
+				_value.push_back(0);
+				_weight.push_back(0.0F);
+				_count.push_back(0);
+				_flags.push_back(0);
+				Update(i, item);
+			}
+
+			BuildNameRanks();
+		}
+
+		void Clear()
+		{
+			_formID.clear();
+			_value.clear();
+			_weight.clear();
+			_count.clear();
+			_flags.clear();
+			_traits.clear();
+			_rank.clear();
+			_type.clear();
+			_recent.clear();
+			_nameRank.clear();
+			_icon.clear();
+			_nameOffset.clear();
+			_names.clear();
+			_foldedOffset.clear();
+			_folded.clear();
+			_keyOffset.clear();
+			_collation.clear();
+			_source.clear();
+			_order.clear();
+		}
+
+		// Re-reads the columns that depend on the stack size, an emptied row drops out on the next Select
+		void Update(std::uint32_t a_row, const Item& a_item)
+		{
+			_value[a_row] = static_cast<std::int32_t>(a_item.Value());
+			_weight[a_row] = static_cast<float>(a_item.Weight());
+			_count[a_row] = static_cast<std::int32_t>(a_item.Count());
+			_flags[a_row] = a_item.RowFlags() | (a_item.InContainer() ? kInContainer : 0);
+		}
+
+		// Only reorders _order, every mode is a radix sort over a key made from the columns
+		void Sort(SortMode a_mode)
+		{
+			_keys.resize(_order.size());
+			for (std::size_t i = 0; i < _order.size(); ++i) {
+				_keys[i] = MakeKey(a_mode, _order[i]);
+			}
+			RadixSort(_keys, _order, _keysTmp, _scratch);
+		}
+
+		// Returns the container row holding the given object, displayed or not
+		[[nodiscard]] std::optional<std::uint32_t> FindInContainer(RE::FormID a_formID) const
+		{
+			for (std::uint32_t row = 0; row < _formID.size(); ++row) {
+				if (_formID[row] == a_formID && (_flags[row] & kInContainer) != 0) {
+					return row;
+				}
+			}
+			return std::nullopt;
+		}
+
+		// Rebuilds the display order from a selection mask, one bit per row, low bit first. Rows past
+		// the end of a mask built for a smaller store are left out
+		void Select(std::span<const std::uint8_t> a_mask)
+		{
+			assert(a_mask.size() * 8 >= _formID.size());
+			_order.clear();
+			const auto rows = static_cast<std::uint32_t>(std::min(_formID.size(), a_mask.size() * 8));
+			for (std::uint32_t row = 0; row < rows; ++row) {
+				if ((a_mask[row / 8] >> (row % 8)) & 1) {
+					_order.push_back(row);
+				}
+			}
+		}
+
+		// Narrows the display order to a subsequence of it, as produced by Items::Search
+		void Restrict(std::span<const std::uint32_t> a_rows) { _order.assign(a_rows.begin(), a_rows.end()); }
+
+		[[nodiscard]] std::size_t Rows() const noexcept { return _formID.size(); }
+		[[nodiscard]] std::span<const RE::FormID> FormIDs() const noexcept { return _formID; }
+		[[nodiscard]] std::span<const std::int32_t> Values() const noexcept { return _value; }
+		[[nodiscard]] std::span<const float> Weights() const noexcept { return _weight; }
+		[[nodiscard]] std::span<const std::int32_t> Counts() const noexcept { return _count; }
+		[[nodiscard]] std::span<const std::uint32_t> Flags() const noexcept { return _flags; }
+		[[nodiscard]] std::span<const std::uint32_t> Traits() const noexcept { return _traits; }
+
+		[[nodiscard]] std::size_t size() const noexcept { return _order.size(); }
+		[[nodiscard]] bool empty() const noexcept { return _order.empty(); }
+
+		[[nodiscard]] std::uint32_t Row(std::size_t a_pos) const { return _order[a_pos]; }
+		[[nodiscard]] std::span<const std::uint32_t> Order() const noexcept { return _order; }
+
+		[[nodiscard]] RE::FormID FormID(std::uint32_t a_row) const { return _formID[a_row]; }
+		[[nodiscard]] std::int32_t Value(std::uint32_t a_row) const { return _value[a_row]; }
+		[[nodiscard]] float Weight(std::uint32_t a_row) const { return _weight[a_row]; }
+		[[nodiscard]] std::int32_t Count(std::uint32_t a_row) const { return _count[a_row]; }
+		[[nodiscard]] std::uint32_t RowFlags(std::uint32_t a_row) const { return _flags[a_row] & ~kInContainer; }
+		[[nodiscard]] std::uint32_t IconIndex(std::uint32_t a_row) const { return _icon[a_row]; }
+		[[nodiscard]] std::uint32_t Source(std::uint32_t a_row) const { return _source[a_row]; }
+
+		// Null terminated, the view can be handed to C APIs
+		[[nodiscard]] std::string_view Name(std::uint32_t a_row) const
+		{
+			const auto first = _nameOffset[a_row];
+			const auto last = a_row + 1 < _nameOffset.size() ? _nameOffset[a_row + 1] : static_cast<std::uint32_t>(_names.size());
+			return { _names.data() + first, last - first - 1 };
+		}
+
+		// Case folded copy of Name for searching
+		[[nodiscard]] std::string_view FoldedName(std::uint32_t a_row) const
+		{
+			const auto first = _foldedOffset[a_row];
+			const auto last = a_row + 1 < _foldedOffset.size() ? _foldedOffset[a_row + 1] : static_cast<std::uint32_t>(_folded.size());
+			return { _folded.data() + first, last - first };
+		}
+
+	private:
+		// Name order by collation key with the form ID as tie break, computed once per Assign so no mode compares strings
+		void BuildNameRanks()
+		{
+			_scratch.resize(_formID.size());
+			std::iota(_scratch.begin(), _scratch.end(), 0u);
+			std::sort(_scratch.begin(), _scratch.end(), [&](std::uint32_t a_lhs, std::uint32_t a_rhs) {
+				const auto alphabetical = CollationKey(a_lhs).compare(CollationKey(a_rhs));
+				return alphabetical != 0 ? alphabetical < 0 : _formID[a_lhs] < _formID[a_rhs];
+			});
+
+			_nameRank.resize(_scratch.size());
+			for (std::uint32_t i = 0; i < _scratch.size(); ++i) {
+				_nameRank[_scratch[i]] = i;
+			}
+		}
+
+		// Ascending keys, descending fields are stored inverted
+		[[nodiscard]] std::uint64_t MakeKey(SortMode a_mode, std::uint32_t a_row) const
+		{
+			const auto name = static_cast<std::uint64_t>(_nameRank[a_row]);
+			const auto value = static_cast<std::uint64_t>(static_cast<std::uint32_t>(_value[a_row]) ^ 0x80000000u);
+			switch (a_mode) {
+			case SortMode::kValue:
+				return (static_cast<std::uint64_t>(~value & 0xFFFFFFFF) << 32) | name;
+			case SortMode::kWeight:
+				return (static_cast<std::uint64_t>(OrderedFloat(_weight[a_row])) << 32) | name;
+			case SortMode::kValuePerWeight:
+				{
+					const auto weight = _weight[a_row];
+					const auto ratio = weight > 0.0F ? static_cast<float>(_value[a_row]) / weight : std::numeric_limits<float>::infinity();
+					return (static_cast<std::uint64_t>(~OrderedFloat(ratio)) << 32) | name;
+				}
+			case SortMode::kName:
+				return name;
+			case SortMode::kType:
+				return (static_cast<std::uint64_t>(_type[a_row]) << 32) | name;
+			case SortMode::kRecent:
+				return (static_cast<std::uint64_t>(~_recent[a_row]) << 32) | name;
+			case SortMode::kDefault:
+			default:
+				return (static_cast<std::uint64_t>(static_cast<std::uint8_t>(~_rank[a_row])) << 56) |
+				       ((~value & 0xFFFFFFFF) << 24) |
+				       (name & 0xFFFFFF);
+			}
+		}
+
+		// Maps a float onto an unsigned integer with the same ordering
+		[[nodiscard]] static std::uint32_t OrderedFloat(float a_value) noexcept
+		{
+			const auto bits = std::bit_cast<std::uint32_t>(a_value);
+			return (bits & 0x80000000u) != 0 ? ~bits : bits | 0x80000000u;
+		}
+
+		[[nodiscard]] std::string_view CollationKey(std::uint32_t a_row) const
+		{
+			const auto first = _keyOffset[a_row];
+			const auto last = a_row + 1 < _keyOffset.size() ? _keyOffset[a_row + 1] : static_cast<std::uint32_t>(_collation.size());
+			return { _collation.data() + first, last - first };
+		}
+
+		std::uint32_t InternKey(std::string_view a_name)
+		{
+			const auto offset = static_cast<std::uint32_t>(_collation.size());
+			Collation::AppendKey(_collation, a_name);
+			return offset;
+		}
+
+		std::uint32_t InternFolded(std::string_view a_name)
+		{
+			const auto offset = static_cast<std::uint32_t>(_folded.size());
+			Collation::AppendFolded(_folded, a_name);
+			return offset;
+		}
+
+		std::uint32_t Intern(std::string_view a_name)
+		{
+			const auto offset = static_cast<std::uint32_t>(_names.size());
+			_names.append(a_name);
+			_names.push_back('\0');
+			return offset;
+		}
+
+		std::vector<RE::FormID> _formID;
+		std::vector<std::int32_t> _value;
+		std::vector<float> _weight;
+		std::vector<std::int32_t> _count;
+		std::vector<std::uint32_t> _flags;
+		std::vector<std::uint32_t> _traits;
+		std::vector<std::uint8_t> _rank;
+		std::vector<std::uint16_t> _type;
+		std::vector<std::uint32_t> _recent;
+		std::vector<std::uint32_t> _nameRank;
+		std::vector<std::uint32_t> _icon;
+		std::vector<std::uint32_t> _nameOffset;
+		std::string _names;
+		std::vector<std::uint32_t> _foldedOffset;
+		std::string _folded;
+		std::vector<std::uint32_t> _keyOffset;
+		std::string _collation;  // binary sort keys of the names
+		std::vector<std::uint32_t> _source;
+		std::vector<std::uint32_t> _order;
+
+		std::vector<std::uint64_t> _keys;
+		std::vector<std::uint64_t> _keysTmp;
+		std::vector<std::uint32_t> _scratch;
+	};
+}
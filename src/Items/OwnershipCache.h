@@ -0,0 +1,135 @@
+#pragma once
+
+#include "Diagnostics/Watchdog.h"
+
+namespace Items
+{
+	// Memoizes the ownership questions asked for every row of a refresh. The container level answer
+	// covers every inventory entry without its own ExtraOwnership, ground refs are resolved once each.
+	// Everything is dropped when a crime, quest stage (faction changes come from quests) or game load
+	// is reported, a moved ref only drops its own answer.
+	class OwnershipCache :
+		public RE::BSTEventSink<RE::TESContainerChangedEvent>,
+		public RE::BSTEventSink<RE::TESLoadGameEvent>,
+		public RE::BSTEventSink<RE::TESQuestStageEvent>,
+		public RE::BSTEventSink<RE::TESTrackedStatsEvent>
+	{
+	public:
+		[[nodiscard]] static OwnershipCache* GetSingleton()
+		{
+			static OwnershipCache singleton;
+			return std::addressof(singleton);
+		}
+
+		static void Register()
+		{
+			auto scripts = RE::ScriptEventSourceHolder::GetSingleton();
+			if (scripts) {
+				scripts->AddEventSink<RE::TESContainerChangedEvent>(GetSingleton());
+				scripts->AddEventSink<RE::TESLoadGameEvent>(GetSingleton());
+				scripts->AddEventSink<RE::TESQuestStageEvent>(GetSingleton());
+				scripts->AddEventSink<RE::TESTrackedStatsEvent>(GetSingleton());
+				logger::info("Registered {}"sv, typeid(OwnershipCache).name());
+			}
+		}
+
+		// Whether the player taking from the container is theft, before per-entry ownership
+		[[nodiscard]] bool WouldBeStealing(RE::TESObjectREFR& a_container)
+		{
+			const auto player = RE::PlayerCharacter::GetSingleton();
+			if (!player) {
+				return false;
+			}
+
+			std::scoped_lock l{ _lock };
+			const auto [it, inserted] = _containers.try_emplace(a_container.GetFormID(), false);
+			if (inserted) {
+				it->second = player->WouldBeStealing(std::addressof(a_container));
+			}
+			return it->second;
+		}
+
+		[[nodiscard]] bool IsCrimeToActivate(RE::TESObjectREFR& a_ref)
+		{
+			std::scoped_lock l{ _lock };
+			const auto [it, inserted] = _refs.try_emplace(a_ref.GetHandle().native_handle(), false);
+			if (inserted) {
+				it->second = a_ref.IsCrimeToActivate();
+			}
+			return it->second;
+		}
+
+		// Entries without an owner of their own inherit the container level answer
+		[[nodiscard]] static bool HasOwnOwnership(const RE::InventoryEntryData& a_entry)
+		{
+			if (a_entry.extraLists) {
+				for (const auto& xList : *a_entry.extraLists) {
+					if (xList && xList->HasType<RE::ExtraOwnership>()) {
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+
+		void Invalidate()
+		{
+			std::scoped_lock l{ _lock };
+			_containers.clear();
+			_refs.clear();
+		}
+
+	protected:
+		using EventResult = RE::BSEventNotifyControl;
+
+		// A ref that was picked up or dropped may have changed hands, containers keep their owner
+		EventResult ProcessEvent(const RE::TESContainerChangedEvent* a_event, RE::BSTEventSource<RE::TESContainerChangedEvent>*) override
+		{
+			Diagnostics::Watchdog::Scope watch{ "OwnershipCache::TESContainerChangedEvent"sv };
+
+			if (a_event && a_event->reference) {
+				std::scoped_lock l{ _lock };
+				_refs.erase(a_event->reference.native_handle());
+			}
+			return EventResult::kContinue;
+		}
+
+		EventResult ProcessEvent(const RE::TESLoadGameEvent*, RE::BSTEventSource<RE::TESLoadGameEvent>*) override
+		{
+			Diagnostics::Watchdog::Scope watch{ "OwnershipCache::TESLoadGameEvent"sv };
+
+			Invalidate();
+			return EventResult::kContinue;
+		}
+
+		EventResult ProcessEvent(const RE::TESQuestStageEvent*, RE::BSTEventSource<RE::TESQuestStageEvent>*) override
+		{
+			Diagnostics::Watchdog::Scope watch{ "OwnershipCache::TESQuestStageEvent"sv };
+
+			Invalidate();
+			return EventResult::kContinue;
+		}
+
+		EventResult ProcessEvent(const RE::TESTrackedStatsEvent*, RE::BSTEventSource<RE::TESTrackedStatsEvent>*) override
+		{
+			Diagnostics::Watchdog::Scope watch{ "OwnershipCache::TESTrackedStatsEvent"sv };
+
+			Invalidate();
+			return EventResult::kContinue;
+		}
+
+	private:
+		OwnershipCache() = default;
+		OwnershipCache(const OwnershipCache&) = delete;
+		OwnershipCache(OwnershipCache&&) = delete;
+
+		~OwnershipCache() = default;
+
+		OwnershipCache& operator=(const OwnershipCache&) = delete;
+		OwnershipCache& operator=(OwnershipCache&&) = delete;
+
+		std::mutex _lock;
+		std::unordered_map<RE::FormID, bool> _containers;
+		std::unordered_map<std::uint32_t, bool> _refs;  // by ref handle
+	};
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+// Engine independent, ItemStore and the host bench in bench/ both build it
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Items
+{
+	// Stable LSD radix sort of a_order by a_keys, one byte per pass, skipping bytes every key shares.
+	// a_keysTmp and a_orderTmp are scratch, kept by the caller so repeated sorts don't allocate
+	inline void RadixSort(
+		std::vector<std::uint64_t>& a_keys,
+		std::vector<std::uint32_t>& a_order,
+		std::vector<std::uint64_t>& a_keysTmp,
+		std::vector<std::uint32_t>& a_orderTmp)
+	{
+		const auto size = a_order.size();
+		a_keysTmp.resize(size);
+		a_orderTmp.resize(size);
+
+		for (std::size_t shift = 0; shift < 64; shift += 8) {
+			std::array<std::size_t, 256> offsets{};
+			for (const auto key : a_keys) {
+				++offsets[(key >> shift) & 0xFF];
+			}
+
+			if (std::find(offsets.begin(), offsets.end(), size) != offsets.end()) {
+				continue;
+			}
+
+			std::size_t sum = 0;
+			for (auto& offset : offsets) {
+				sum += std::exchange(offset, sum);
+			}
+
+			for (std::size_t i = 0; i < size; ++i) {
+				const auto pos = offsets[(a_keys[i] >> shift) & 0xFF]++;
+				a_keysTmp[pos] = a_keys[i];
+				a_orderTmp[pos] = a_order[i];
+			}
+
+			a_keys.swap(a_keysTmp);
+			a_order.swap(a_orderTmp);
+		}
+	}
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Items/ItemStore.h"
+
+namespace Items
+{
+	// Incremental type-to-filter over the store's folded names. Every keystroke narrows the rows that
+	// matched the previous query, backspace pops back to them, so typing never rescans the whole list.
+	class Search
+	{
+	public:
+		[[nodiscard]] bool Active() const noexcept { return _active; }
+		[[nodiscard]] std::string_view Query() const noexcept { return _query; }
+
+		void Begin()
+		{
+			_active = true;
+			_query.clear();
+			_levels.clear();
+		}
+
+		void End()
+		{
+			_active = false;
+			_query.clear();
+			_levels.clear();
+		}
+
+		// Takes the current display order as the unfiltered base and re-runs the query against it once
+		void Rebase(const ItemStore& a_store)
+		{
+			_base.assign(a_store.Order().begin(), a_store.Order().end());
+			_levels.clear();
+			if (_active && !_query.empty()) {
+				Narrow(a_store, _base);
+			}
+		}
+
+		void Push(const ItemStore& a_store, char32_t a_char)
+		{
+			if (_active) {
+				Collation::AppendFolded(_query, a_char);
+				Narrow(a_store, Results(_levels.size()));
+			}
+		}
+
+		void Pop(const ItemStore& a_store)
+		{
+			if (!_active || _query.empty()) {
+				return;
+			}
+
+			do {
+				_query.pop_back();
+			} while (!_query.empty() && (static_cast<unsigned char>(_query.back()) & 0xC0) == 0x80);
+
+			if (!_levels.empty()) {
+				_levels.pop_back();
+			}
+
+			// Rebase collapses the stack into one level, shorter queries are then recomputed from the base
+			if (_levels.empty() && !_query.empty()) {
+				Narrow(a_store, _base);
+			}
+		}
+
+		// The rows to display, in display order
+		[[nodiscard]] std::span<const std::uint32_t> Results() const noexcept
+		{
+			return _query.empty() ? _base : Results(_levels.size());
+		}
+
+		// Display size before the query is applied
+		[[nodiscard]] std::size_t BaseSize() const noexcept { return _base.size(); }
+
+	private:
+		[[nodiscard]] std::span<const std::uint32_t> Results(std::size_t a_depth) const noexcept
+		{
+			return a_depth > 0 ? std::span<const std::uint32_t>{ _levels[a_depth - 1] } : std::span<const std::uint32_t>{ _base };
+		}
+
+		void Narrow(const ItemStore& a_store, std::span<const std::uint32_t> a_rows)
+		{
+			std::vector<std::uint32_t> next;
+			next.reserve(a_rows.size());
+			for (const auto row : a_rows) {
+				if (a_store.FoldedName(row).find(_query) != std::string_view::npos) {
+					next.push_back(row);
+				}
+			}
+			_levels.push_back(std::move(next));
+		}
+
+		std::string _query;  // folded like the store's names
+		std::vector<std::uint32_t> _base;
+		std::vector<std::vector<std::uint32_t>> _levels;  // the back level always matches the whole query
+		bool _active{ false };
+	};
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include "Diagnostics/EventTrace.h"
+#include "FrameContext.h"
+
+namespace Items
+{
+	// Groups the removals of one or more takes so the engine notifications fire once per transaction:
+	// one pickup event per container/object pair, one pickup sound and one steal alarm per container.
+	// The destination and frame are only borrowed for the tick, a transaction that spans several ticks
+	// is rebound to each one and keeps nothing but handles in between.
+	class TakeTransaction
+	{
+	public:
+		TakeTransaction() = delete;
+		TakeTransaction(const TakeTransaction&) = delete;
+		TakeTransaction(TakeTransaction&&) = delete;
+
+		explicit TakeTransaction(RE::Actor& a_dst) :
+			_dst(std::addressof(a_dst))
+		{}
+
+		TakeTransaction(RE::Actor& a_dst, const FrameContext& a_frame) :
+			_dst(std::addressof(a_dst)),
+			_frame(std::addressof(a_frame))
+		{}
+
+		~TakeTransaction() { Commit(); }
+
+		TakeTransaction& operator=(const TakeTransaction&) = delete;
+		TakeTransaction& operator=(TakeTransaction&&) = delete;
+
+		[[nodiscard]] RE::Actor& Destination() const noexcept { return *_dst; }
+
+		// Binds the transaction to the current tick, nothing queued may be left from the previous one
+		void Rebind(RE::Actor& a_dst, const FrameContext& a_frame)
+		{
+			assert(_removals.empty() && _pickUps.empty());
+			_dst = std::addressof(a_dst);
+			_frame = std::addressof(a_frame);
+		}
+
+		// Drops everything still queued, for a job whose destination is gone
+		void Abandon()
+		{
+			_removals.clear();
+			_pickUps.clear();
+			_thefts.clear();
+			_sound = nullptr;
+		}
+
+		// Resolves a container handle, reusing the ref the menu resolved for the current tick
+		[[nodiscard]] RE::TESObjectREFRPtr Container(RE::ObjectRefHandle a_handle) const
+		{
+			return _frame ? _frame->Container(a_handle) : a_handle.get();
+		}
+
+		void QueueRemove(RE::TESObjectREFR& a_container, RE::TESBoundObject& a_object, std::int32_t a_count, RE::ExtraDataList* a_extraList, bool a_stolen)
+		{
+			_removals.push_back({ RE::TESObjectREFRPtr{ std::addressof(a_container) }, std::addressof(a_object), a_count, a_extraList, a_stolen });
+			Notify(std::addressof(a_object));
+		}
+
+		void QueuePickUp(RE::TESObjectREFR& a_item, std::int32_t a_count)
+		{
+			_pickUps.push_back({ RE::TESObjectREFRPtr{ std::addressof(a_item) }, a_count });
+			Notify(a_item.GetObjectReference());
+		}
+
+		// a_value is per unit. A container's thefts add up into one alarm, which names the object
+		// worth the most of them
+		void AddStolen(RE::TESObjectREFR& a_container, RE::TESBoundObject& a_object, std::int32_t a_count, std::int32_t a_value)
+		{
+			const auto handle = a_container.GetHandle();
+			auto it = std::find_if(_thefts.begin(), _thefts.end(), [&](auto&& a_theft) {
+				return a_theft.container == handle;
+			});
+			if (it == _thefts.end()) {
+				_thefts.push_back({ handle, std::addressof(a_object), 0, 0, 0 });
+				it = std::prev(_thefts.end());
+			}
+
+			const auto value = a_value * a_count;
+			if (value >= it->topValue) {
+				it->object = std::addressof(a_object);
+				it->topValue = value;
+			}
+			it->count += a_count;
+			it->value += value;
+		}
+
+		// Performs every queued removal, leaving the one-shot notifications for Commit
+		void Flush()
+		{
+			if (Replaying()) {
+				_removals.clear();
+				_pickUps.clear();
+				return;
+			}
+
+			for (auto it = _removals.begin(); it != _removals.end(); ++it) {
+				const auto reason = it->stolen ? RE::ITEM_REMOVE_REASON::kSteal : RE::ITEM_REMOVE_REASON::kRemove;
+				it->container->RemoveItem(it->object, it->count, reason, it->extraList, _dst);
+
+				const auto next = std::next(it);
+				if (next == _removals.end() || next->container != it->container || next->object != it->object) {
+					PlayPickupEvent(*it->container, *it->object);
+				}
+			}
+			_removals.clear();
+
+			for (auto& [item, count] : _pickUps) {
+				_dst->PickUpObject(item.get(), count, false, false);
+			}
+			_pickUps.clear();
+		}
+
+		void Commit()
+		{
+			if (Replaying()) {
+				Abandon();
+				return;
+			}
+
+			Flush();
+
+			for (auto& theft : _thefts) {
+				if (const auto container = Container(theft.container); container) {
+					_dst->StealAlarm(container.get(), theft.object, theft.count, theft.value, container->GetOwner(), true);
+				}
+			}
+			_thefts.clear();
+
+			if (_sound) {
+				_dst->PlayPickUpSound(_sound, true, false);
+				_sound = nullptr;
+			}
+		}
+
+	private:
+		// A replay feeds the recorded container changes back in, so the takes it drives are dropped
+		// instead of being performed a second time on the live world
+		[[nodiscard]] static bool Replaying() noexcept { return Diagnostics::EventTrace::Replaying(); }
+
+		struct Removal
+		{
+			RE::TESObjectREFRPtr container;
+			RE::TESBoundObject* object;
+			std::int32_t count;
+			RE::ExtraDataList* extraList;
+			bool stolen;
+		};
+
+		struct PickUp
+		{
+			RE::TESObjectREFRPtr item;
+			std::int32_t count;
+		};
+
+		struct Theft
+		{
+			RE::ObjectRefHandle container;
+			RE::TESBoundObject* object;
+			std::int32_t count;
+			std::int32_t value;
+			std::int32_t topValue;  // of the named object
+		};
+
+		void Notify(RE::TESBoundObject* a_object)
+		{
+			if (!_sound) {
+				_sound = a_object;
+			}
+		}
+
+		void PlayPickupEvent(RE::TESObjectREFR& a_container, RE::TESBoundObject& a_object)
+		{
+			if (_dst->IsPlayerRef()) {
+				auto& player = static_cast<RE::PlayerCharacter&>(*_dst);
+				player.PlayPickupEvent(std::addressof(a_object), a_container.GetOwner(), std::addressof(a_container), RE::PlayerCharacter::EventType::kContainer);
+			}
+		}
+
+		RE::Actor* _dst;
+		const FrameContext* _frame{ nullptr };
+		RE::TESBoundObject* _sound{ nullptr };
+		std::vector<Removal> _removals;
+		std::vector<PickUp> _pickUps;
+		std::vector<Theft> _thefts;
+	};
+}
@@ -1,5 +1,6 @@
 #include "Loot.h"
 
+#include "Diagnostics/Watchdog.h"
 #include "HUDManager.h"
 #include "Scaleform/LootMenu.h"
 
@@ -41,13 +42,68 @@ void Loot::ModSelectedPage(double a_mod)
 	});
 }
 
+void Loot::CycleSortMode()
+{
+	AddTask([](LootMenu& a_menu) {
+		a_menu.CycleSortMode();
+	});
+}
+
+void Loot::ToggleSearch()
+{
+	if (!IsOpen()) {
+		return;
+	}
+
+	if (!_searching.exchange(true)) {
+		AddTask([](LootMenu& a_menu) {
+			a_menu.BeginSearch();
+		});
+	} else {
+		AddTask([](LootMenu& a_menu) {
+			a_menu.EndSearch();
+		});
+	}
+}
+
+void Loot::AppendSearch(char32_t a_char)
+{
+	AddTask([a_char](LootMenu& a_menu) {
+		a_menu.AppendSearch(a_char);
+	});
+}
+
+void Loot::PopSearch()
+{
+	AddTask([](LootMenu& a_menu) {
+		a_menu.PopSearch();
+	});
+}
+
 void Loot::SetContainer(RE::ObjectRefHandle a_container)
 {
+	const auto ref = a_container.get();
+	_container = ref ? ref->GetFormID() : 0;
+	_revalidate = true;
+
+	// Deltas still queued belong to the previous container's rows
+	{
+		std::scoped_lock l{ _lock };
+		_deltas.clear();
+	}
+
 	AddTask([a_container](LootMenu& a_menu) {
 		a_menu.SetContainer(a_container);
 	});
 }
 
+void Loot::TakeAll()
+{
+	AddTask([](LootMenu& a_menu) {
+		a_menu.TakeAll();
+	});
+}
+
 void Loot::TakeStack()
 {
 	AddTask([](LootMenu& a_menu) {
@@ -57,6 +113,8 @@ void Loot::TakeStack()
 
 void Loot::Process(LootMenu& a_menu)
 {
+	Diagnostics::Watchdog::Scope watch{ "Loot::Process"sv };
+
 	if (!_taskQueue.empty()) {
 		for (auto& task : _taskQueue) {
 			task(a_menu);
@@ -64,19 +122,37 @@ void Loot::Process(LootMenu& a_menu)
 		_taskQueue.clear();
 	}
 
+	if (_revalidate.exchange(false)) {
+		a_menu.Revalidate();
+	}
+
+	// Refreshes stay queued until the job is done, which then queues the final one itself
+	if (a_menu.ContinueTakeAll()) {
+		return;
+	}
+
+	{
+		std::scoped_lock l{ _lock };
+		_pendingDeltas.swap(_deltas);
+	}
+
 	if (_refreshUI) {
 		a_menu.RefreshUI();
 	} else if (_refreshInventory) {
 		a_menu.RefreshInventory();
+	} else if (!_pendingDeltas.empty() && !a_menu.ApplyInventoryDeltas(_pendingDeltas)) {
+		a_menu.RefreshInventory();
 	}
+	_pendingDeltas.clear();
 
 	_refreshUI = false;
 	_refreshInventory = false;
 }
 
-void Loot::AddTask(Tasklet a_task)
+void Loot::AddTask(Tasklet a_task, std::source_location a_where)
 {
 	Open();
+	Diagnostics::Watchdog::NoteTask(a_where.function_name());
 	std::scoped_lock l{ _lock };
 	_taskQueue.push_back(std::move(a_task));
 }
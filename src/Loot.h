@@ -1,5 +1,9 @@
 #pragma once
 
+#include "ContainerChangedHandler.h"
+
+#include <source_location>
+
 namespace Scaleform
 {
 	class LootMenu;
@@ -50,13 +54,59 @@ public:
 		});
 	}
 
+	// Deltas are coalesced per object and applied to the current model once per frame
+	void RefreshInventory(const InventoryDelta& a_delta)
+	{
+		std::scoped_lock l{ _lock };
+		auto it = std::find_if(_deltas.begin(), _deltas.end(), [&](auto&& a_elem) {
+			return a_elem.object == a_delta.object;
+		});
+		if (it != _deltas.end()) {
+			// A removal and an add that cancel out still changed which stacks the object is in
+			const auto cancelled = it->count != 0 && it->count + a_delta.count == 0;
+			it->count += a_delta.count;
+			it->rescan = it->rescan || a_delta.rescan || cancelled;
+		} else {
+			_deltas.push_back(a_delta);
+		}
+	}
+
+	void CycleSortMode();
+
+	// Flags the displayed container for a validity check on the next frame, called by the events
+	// that can invalidate it so the menu doesn't have to poll
+	void Revalidate(RE::FormID a_ref) noexcept
+	{
+		if (a_ref != 0 && a_ref == _container) {
+			_revalidate = true;
+		}
+	}
+
+	[[nodiscard]] bool IsSearching() const noexcept { return _searching; }
+
+	// The menu is open, or work is queued that will open it
+	[[nodiscard]] bool HasMenuWork() const
+	{
+		{
+			std::scoped_lock l{ _lock };
+			if (!_taskQueue.empty()) {
+				return true;
+			}
+		}
+		return IsOpen();
+	}
+	void ToggleSearch();
+	void AppendSearch(char32_t a_char);
+	void PopSearch();
 	void SetContainer(RE::ObjectRefHandle a_container);
+	void TakeAll();
 	void TakeStack();
 
 protected:
 	friend class LootMenu;
 
 	void Process(LootMenu& a_menu);
+	void OnSearchEnded() noexcept { _searching = false; }
 
 private:
 	using Tasklet = std::function<void(LootMenu&)>;
@@ -70,7 +120,7 @@ private:
 	Loot& operator=(const Loot&) = delete;
 	Loot& operator=(Loot&&) = delete;
 
-	void AddTask(Tasklet a_task);
+	void AddTask(Tasklet a_task, std::source_location a_where = std::source_location::current());
 
 	[[nodiscard]] RE::GPtr<LootMenu> GetMenu() const;
 	[[nodiscard]] bool IsOpen() const;
@@ -97,7 +147,12 @@ private:
 
 	mutable std::mutex _lock;
 	std::vector<Tasklet> _taskQueue;
+	std::vector<InventoryDelta> _deltas;
+	std::vector<InventoryDelta> _pendingDeltas;
 	std::atomic_bool _enabled{ true };
+	std::atomic_bool _searching{ false };  // mirrors the menu, read on the input thread
+	std::atomic_bool _revalidate{ false };
+	std::atomic<RE::FormID> _container{ 0 };
 	bool _refreshUI{ false };
 	bool _refreshInventory{ false };
 };
@@ -0,0 +1,180 @@
+#include "Scaleform/LogSink.h"
+
+namespace Scaleform
+{
+	namespace
+	{
+		[[nodiscard]] std::uint64_t Hash(std::string_view a_text) noexcept
+		{
+			std::uint64_t hash = 14695981039346656037ull;
+			for (const auto c : a_text) {
+				hash = (hash ^ static_cast<std::uint8_t>(c)) * 1099511628211ull;
+			}
+			return hash;
+		}
+	}
+
+	LogSink::LogSink() :
+		_flusher([this](std::stop_token a_stop) { Flush(a_stop); })
+	{
+		std::atexit([]() { GetSingleton().Shutdown(); });
+	}
+
+	void LogSink::Push(std::string_view a_source, const char* a_fmt, std::va_list a_args)
+	{
+		std::scoped_lock l{ _lock };
+
+		auto& site = FindSite(a_fmt);
+		if (!TakeToken(site)) {
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		const auto slot = Reserve();
+		if (!slot) {
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		// The only formatting pass, truncated to the slot
+		const auto written = std::vsnprintf(slot->text.data(), slot->text.size(), a_fmt ? a_fmt : "", a_args);
+		auto size = static_cast<std::size_t>(std::clamp<int>(written, 0, static_cast<int>(slot->text.size() - 1)));
+		while (size > 0 && slot->text[size - 1] == '\n') {
+			--size;
+		}
+
+		const auto hash = Hash({ slot->text.data(), size });
+		if (hash == site.last) {
+			++site.repeats;
+			_folded.fetch_add(1, std::memory_order_relaxed);
+			return;  // the slot was never committed
+		}
+
+		slot->source = a_source;
+		slot->size = static_cast<std::uint32_t>(size);
+		if (site.repeats > 0) {
+			// The repeat note must come first, move the message up a slot
+			const auto message = *slot;
+			PushRepeats(a_source, site);
+			if (const auto next = Reserve(); next) {
+				*next = message;
+			} else {
+				_dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+		}
+
+		site.last = hash;
+		Commit();
+	}
+
+	auto LogSink::FindSite(const char* a_fmt)
+		-> Site&
+	{
+		// Open addressing on the format string's address, a full table recycles the home slot
+		const auto home = std::hash<const void*>{}(a_fmt) % SITE_COUNT;
+		for (std::size_t i = 0; i < SITE_COUNT; ++i) {
+			auto& site = _sites[(home + i) % SITE_COUNT];
+			if (site.fmt == a_fmt) {
+				return site;
+			} else if (!site.fmt) {
+				site = { a_fmt, 0, 0, SITE_BURST, std::chrono::steady_clock::now() };
+				return site;
+			}
+		}
+
+		auto& site = _sites[home];
+		site = { a_fmt, 0, 0, SITE_BURST, std::chrono::steady_clock::now() };
+		return site;
+	}
+
+	bool LogSink::TakeToken(Site& a_site)
+	{
+		const auto now = std::chrono::steady_clock::now();
+		const std::chrono::duration<float> elapsed = now - a_site.refill;
+		a_site.tokens = std::min(a_site.tokens + elapsed.count() * SITE_RATE, SITE_BURST);
+		a_site.refill = now;
+
+		if (a_site.tokens < 1.0F) {
+			return false;
+		}
+
+		a_site.tokens -= 1.0F;
+		return true;
+	}
+
+	auto LogSink::Reserve() noexcept
+		-> Slot*
+	{
+		const auto head = _head.load(std::memory_order_relaxed);
+		if (head - _tail.load(std::memory_order_acquire) >= RING_SIZE) {
+			return nullptr;
+		}
+		return std::addressof(_ring[head % RING_SIZE]);
+	}
+
+	void LogSink::PushRepeats(std::string_view a_source, Site& a_site)
+	{
+		// Reserve handed out the slot the caller is holding, it is overwritten and committed here
+		auto& slot = _ring[_head.load(std::memory_order_relaxed) % RING_SIZE];
+		const auto result = fmt::format_to_n(slot.text.data(), slot.text.size(), "last message repeated {} times"sv, a_site.repeats);
+		slot.source = a_source;
+		slot.size = static_cast<std::uint32_t>(std::min(result.size, slot.text.size()));
+		a_site.repeats = 0;
+		Commit();
+	}
+
+	void LogSink::Flush(std::stop_token a_stop)
+	{
+		auto lastReport = std::chrono::steady_clock::now();
+		while (!a_stop.stop_requested()) {
+			Drain();
+
+			if (const auto now = std::chrono::steady_clock::now(); now - lastReport >= REPORT_INTERVAL) {
+				Report();
+				lastReport = now;
+			}
+
+			std::unique_lock l{ _wakeLock };
+			_wake.wait_for(l, a_stop, FLUSH_INTERVAL, []() { return false; });
+		}
+
+		// The last pass, the log is only ever written from this thread
+		Drain();
+		Report();
+	}
+
+	// Writes what was dropped or folded since the last report, if anything. Runs on the flusher
+	// while the game is up, the pass at shutdown may never come
+	void LogSink::Report()
+	{
+		const auto dropped = _dropped.load(std::memory_order_relaxed);
+		const auto folded = _folded.load(std::memory_order_relaxed);
+		if (dropped != _reportedDropped || folded != _reportedFolded) {
+			logger::info("Movie log: {} messages dropped, {} repeats folded"sv, dropped - _reportedDropped, folded - _reportedFolded);
+			_reportedDropped = dropped;
+			_reportedFolded = folded;
+		}
+	}
+
+	void LogSink::Drain()
+	{
+		auto tail = _tail.load(std::memory_order_relaxed);
+		const auto head = _head.load(std::memory_order_acquire);
+		for (; tail != head; ++tail) {
+			const auto& slot = _ring[tail % RING_SIZE];
+			logger::info("{}: {}"sv, slot.source, std::string_view{ slot.text.data(), slot.size });
+			_tail.store(tail + 1, std::memory_order_release);
+		}
+	}
+
+	// Stops the flusher and waits for its last pass. Nothing is drained here: when the process has
+	// already torn the thread down, it may have died holding the logger's lock, and what it left is lost
+	void LogSink::Shutdown()
+	{
+		_flusher.request_stop();
+		if (_flusher.joinable()) {
+			_flusher.join();
+		}
+	}
+}
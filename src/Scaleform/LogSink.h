@@ -0,0 +1,79 @@
+#pragma once
+
+namespace Scaleform
+{
+	// Takes the movie's log output off the UI thread. A message is formatted once, straight into a
+	// preallocated ring slot, and a background thread writes the ring out. Every message site (its
+	// format string) has a token bucket, and consecutive repeats from a site are folded into a count.
+	class LogSink
+	{
+	public:
+		[[nodiscard]] static LogSink& GetSingleton()
+		{
+			// Never destroyed, a message pushed after the flusher stopped still finds its ring
+			static auto singleton = new LogSink();
+			return *singleton;
+		}
+
+		// a_source must outlive the sink, a string literal
+		void Push(std::string_view a_source, const char* a_fmt, std::va_list a_args);
+
+	private:
+		static constexpr std::size_t MESSAGE_SIZE{ 512 };  // longer messages are truncated
+		static constexpr std::size_t RING_SIZE{ 256 };
+		static constexpr std::size_t SITE_COUNT{ 64 };
+		static constexpr float SITE_RATE{ 5.0F };  // messages per second once the burst is spent
+		static constexpr float SITE_BURST{ 20.0F };
+		static constexpr auto FLUSH_INTERVAL{ 100ms };
+		static constexpr auto REPORT_INTERVAL{ 10s };
+
+		struct Slot
+		{
+			std::string_view source;
+			std::uint32_t size;
+			std::array<char, MESSAGE_SIZE> text;
+		};
+
+		struct Site
+		{
+			const char* fmt;
+			std::uint64_t last;  // hash of the last message written
+			std::uint32_t repeats;
+			float tokens;
+			std::chrono::steady_clock::time_point refill;
+		};
+
+		LogSink();
+		LogSink(const LogSink&) = delete;
+		LogSink(LogSink&&) = delete;
+
+		~LogSink() = default;
+
+		LogSink& operator=(const LogSink&) = delete;
+		LogSink& operator=(LogSink&&) = delete;
+
+		[[nodiscard]] Site& FindSite(const char* a_fmt);
+		[[nodiscard]] bool TakeToken(Site& a_site);
+		[[nodiscard]] Slot* Reserve() noexcept;
+		void Commit() noexcept { _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+		void PushRepeats(std::string_view a_source, Site& a_site);
+
+		void Flush(std::stop_token a_stop);
+		void Drain();
+		void Report();
+		void Shutdown();
+
+		std::mutex _lock;  // serializes producers, the flusher only reads committed slots
+		std::array<Slot, RING_SIZE> _ring;
+		std::atomic_size_t _head{ 0 };
+		std::atomic_size_t _tail{ 0 };
+		std::array<Site, SITE_COUNT> _sites{};
+		std::atomic_uint64_t _dropped{ 0 };
+		std::atomic_uint64_t _folded{ 0 };
+		std::uint64_t _reportedDropped{ 0 };  // flusher only
+		std::uint64_t _reportedFolded{ 0 };
+		std::mutex _wakeLock;
+		std::condition_variable_any _wake;  // only ever woken by a stop request
+		std::jthread _flusher;  // last, it starts once everything else is initialized
+	};
+}
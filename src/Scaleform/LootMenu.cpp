@@ -10,6 +10,12 @@ namespace Scaleform
 		loot.Close();
 	}
 
+	void LootMenu::NotifySearchEnded()
+	{
+		auto& loot = Loot::GetSingleton();
+		loot.OnSearchEnded();
+	}
+
 	void LootMenu::ProcessDelegate()
 	{
 		auto& loot = Loot::GetSingleton();
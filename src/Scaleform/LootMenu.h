@@ -1,14 +1,33 @@
 #pragma once
 
+#include "API/Provider.h"
+#include "Area/LootableGrid.h"
 #include "CLIK/Array.h"
 #include "CLIK/GFx/Controls/ButtonBar.h"
 #include "CLIK/GFx/Controls/ScrollingList.h"
+#include "CLIK/GFx/Controls/TextInput.h"
 #include "CLIK/TextField.h"
 #include "ContainerChangedHandler.h"
+#include "Diagnostics/Counters.h"
+#include "Diagnostics/EventTrace.h"
+#include "Diagnostics/Watchdog.h"
+#include "FrameContext.h"
+#include "Items/Classifier.h"
+#include "Items/DisplayFilter.h"
+#include "Items/Filter.h"
 #include "Items/GroundItem.h"
 #include "Items/InventoryItem.h"
+#include "Items/InventoryView.h"
 #include "Items/Item.h"
+#include "Items/ItemArena.h"
+#include "Items/ItemStore.h"
+#include "Items/OwnershipCache.h"
+#include "Items/Search.h"
 #include "OpenCloseHandler.h"
+#include "Scaleform/LogSink.h"
+#include "Scaleform/PackedItemList.h"
+#include "Scaleform/StringTable.h"
+#include "Scaleform/ViewModel.h"
 #include "ViewHandler.h"
 
 namespace Scaleform
@@ -34,7 +53,7 @@ namespace Scaleform
 
 		void ModSelectedIndex(double a_mod)
 		{
-			const auto maxIdx = static_cast<double>(_itemListImpl.size()) - 1.0;
+			const auto maxIdx = static_cast<double>(_store.size()) - 1.0;
 			if (maxIdx >= 0.0) {
 				auto idx = _itemList.SelectedIndex();
 				idx += a_mod;
@@ -55,86 +74,399 @@ namespace Scaleform
 			UpdateInfoBar();
 		}
 
+		// Closes the menu once its container is gone or blocked, requested by Loot when an event
+		// reports a change to it
+		void Revalidate()
+		{
+			const auto& frame = Frame();
+			if (!frame.src || frame.src->IsActivationBlocked()) {
+				Close();
+			}
+		}
+
+		// A script's BlockActivation raises none of the events Revalidate listens to, so every take
+		// checks the container first
+		[[nodiscard]] bool CloseIfBlocked(const FrameContext& a_frame)
+		{
+			if (a_frame.src && a_frame.src->IsActivationBlocked()) {
+				Close();
+				return true;
+			}
+			return false;
+		}
+
 		void SetContainer(RE::ObjectRefHandle a_ref)
 		{
 			assert(a_ref);
+			CancelTakeAll();
+			EndSearch();
+			DiscardClassification();
 			_src = a_ref;
-			_viewHandler->SetSource(a_ref);
+			_frameResolved = false;
+			Diagnostics::Watchdog::SetContainer(Frame().src ? Frame().src->GetFormID() : 0);
 			_containerChangedHandler.SetContainer(a_ref);
 			_openCloseHandler.SetSource(a_ref);
 			_itemList.SelectedIndex(0);
-			QueueUIRefresh();
+
+			Diagnostics::Counters::Increment(Diagnostics::Counters::kContainersSet);
+			if (_pending) {
+				Diagnostics::Counters::Increment(Diagnostics::Counters::kDwellSkipped);
+			}
+
+			// Rows wait until the crosshair rests on the ref, sweeping past it only costs this
+			const auto dwell = Settings::CrosshairDwellMs();
+			_pending = dwell > 0.0F;
+			if (_pending) {
+				_dwellRemaining = dwell / 1000.0F;
+				_rootObj.Visible(false);
+				_viewHandler->DeferSource(Frame());
+			} else {
+				_viewHandler->SetSource(Frame());
+				QueueUIRefresh();
+			}
 		}
 
-		void RefreshInventory()
+		void RefreshInventory() { RefreshInventory(Frame()); }
+
+		void RefreshInventory(const FrameContext& a_frame)
 		{
+			if (_pending) {
+				return;
+			}
+
+			Diagnostics::Counters::Increment(Diagnostics::Counters::kInventoryRebuilds);
+			DiscardClassification();
 			const auto idx = static_cast<std::ptrdiff_t>(_itemList.SelectedIndex());
 
-			_itemListImpl.clear();
-			auto src = _src.get();
+			_areaSources = 0;
+			const auto& src = a_frame.src;
 			if (!src) {
-				_itemListProvider.ClearElements();
-				_itemList.Invalidate();
+				SwapItemList(0);
+				_packedItems.Assign(_store);
+				CommitRows();
 				_itemList.SelectedIndex(-1.0);
 				return;
 			}
 
-			const auto stealing = WouldBeStealing();
-			auto inv = src->GetInventory(CanDisplay);
-			for (auto& [obj, data] : inv) {
-				auto& [count, entry] = data;
-				if (count > 0 && entry) {
-					_itemListImpl.push_back(
-						std::make_unique<Items::InventoryItem>(
-							count, stealing, std::move(entry), _src));
-				}
-			}
+			auto& arena = _arenas.Back();
+			auto& resource = *arena.Resource();
+			const auto stealing = WouldBeStealing(a_frame);
+			AppendInventory(*src, _src, stealing, std::numeric_limits<std::size_t>::max());
 
 			auto dropped = src->GetDroppedInventory(CanDisplay);
 			for (auto& [obj, data] : dropped) {
 				auto& [count, items] = data;
 				if (count > 0 && !items.empty()) {
-					_itemListImpl.push_back(
-						std::make_unique<Items::GroundItems>(
-							count, stealing, std::move(items)));
+					_nextItems.push_back(
+						arena.Make<Items::GroundItems>(
+							count, stealing, std::pmr::vector<RE::ObjectRefHandle>(items.begin(), items.end(), std::addressof(resource)), resource));
 				}
 			}
 
-			if (_itemListImpl.size() >= 32 || (Settings::CloseWhenEmpty() && _itemListImpl.empty())) {
-				Close();
-			} else {
-				Sort();
-				_itemListProvider.ClearElements();
-				for (const auto& elem : _itemListImpl) {
-					_itemListProvider.PushBack(elem->GFxValue(*_view));
+			if (const auto radius = Settings::AreaLootRadius(); radius > 0.0F && a_frame.dst) {
+				AppendArea(a_frame, radius);
+			}
+
+			ClassifyItems(a_frame, src->GetFormID(), idx);
+		}
+
+		// Small models are classified in place, larger ones go to the workers and are swapped in by
+		// CollectClassified once their batch comes back. The displayed rows stay up meanwhile.
+		void ClassifyItems(const FrameContext& a_frame, RE::FormID a_container, std::ptrdiff_t a_idx)
+		{
+			if (_nextItems.size() <= CLASSIFY_INLINE_MAX) {
+				for (auto& item : _nextItems) {
+					item->Prime(Items::GFxItem::Classify(item->Snapshot()));
+				}
+				SwapItemList(a_container);
+				UpdateItemList(a_frame, a_idx);
+				return;
+			}
+
+			std::vector<Items::ClassifyInput> inputs;
+			inputs.reserve(_nextItems.size());
+			for (const auto& item : _nextItems) {
+				inputs.push_back(item->Snapshot());
+			}
+
+			Diagnostics::Counters::Increment(Diagnostics::Counters::kClassifyBatches);
+			_classifyTicket = Items::Classifier::GetSingleton().Submit(std::move(inputs));
+			_classifyContainer = a_container;
+			_classifyIdx = a_idx;
+		}
+
+		void CollectClassified()
+		{
+			// A take all job walks the displayed store, it must not be swapped out under it
+			if (_classifyTicket == 0 || _takeAll) {
+				return;
+			}
+
+			const auto result = Items::Classifier::GetSingleton().Poll();
+			if (!result || result->ticket != _classifyTicket) {
+				return;
+			}
+
+			_classifyTicket = 0;
+			for (std::size_t i = 0; i < _nextItems.size(); ++i) {
+				_nextItems[i]->Prime(result->rows[i]);
+			}
+			SwapItemList(_classifyContainer);
+			UpdateItemList(Frame(), _classifyIdx);
+		}
+
+		// Drops a model still out with the workers, its result is ignored when it arrives
+		void DiscardClassification()
+		{
+			if (_classifyTicket != 0) {
+				_classifyTicket = 0;
+				_nextItems.clear();
+				_arenas.Back().Reset();
+			}
+		}
+
+		// Adds a container's rows, stopping once the model holds a_limit rows
+		void AppendInventory(RE::TESObjectREFR& a_ref, RE::ObjectRefHandle a_handle, bool a_stealing, std::size_t a_limit)
+		{
+			auto& arena = _arenas.Back();
+			auto& resource = *arena.Resource();
+			_inventory.ForEach(a_ref, CanDisplay, [&](const Items::InventoryView::Entry& a_entry) {
+				if (a_entry.count > 0 && _nextItems.size() < a_limit) {
+					_nextItems.push_back(
+						arena.Make<Items::InventoryItem>(
+							a_entry.count, a_stealing, *a_entry.object, a_handle, resource));
+				}
+			});
+		}
+
+		// Merges the other lootables around the player, nearest first. The grid answers the radius
+		// query, only the refs it returns are resolved.
+		void AppendArea(const FrameContext& a_frame, float a_radius)
+		{
+			_areaRefs.clear();
+			Area::LootableGrid::GetSingleton()->Query(a_frame.dst->GetPosition(), a_radius, _areaRefs);
+
+			const auto ownership = Items::OwnershipCache::GetSingleton();
+			for (const auto handle : _areaRefs) {
+				if (_nextItems.size() >= AREA_ROW_LIMIT) {
+					break;
+				} else if (handle == _src) {
+					continue;
+				}
+
+				const auto ref = handle.get();
+				if (!ref || ref->IsLocked() || ref->IsActivationBlocked()) {
+					continue;
+				}
+
+				const auto size = _nextItems.size();
+				AppendInventory(*ref, handle, ownership->WouldBeStealing(*ref), AREA_ROW_LIMIT);
+				if (_nextItems.size() > size) {
+					++_areaSources;
+				}
+			}
+		}
+
+		// Retires the displayed model and recycles its arena, the next one was built in the back arena
+		void SwapItemList(RE::FormID a_container)
+		{
+			_itemListImpl.swap(_nextItems);
+			_nextItems.clear();
+			_arenas.Swap();
+			_store.Assign(_itemListImpl, a_container);
+		}
+
+		// Patches the current model in place, returning false when a full rescan is needed instead
+		[[nodiscard]] bool ApplyInventoryDeltas(std::span<const InventoryDelta> a_deltas)
+		{
+			if (_pending) {
+				return true;  // the rows are built from scratch once the dwell ends
+			}
+
+			// The rows out with the workers predate the delta, the rescan replaces them
+			if (_classifyTicket != 0) {
+				return false;
+			}
+
+			// Rows from several containers can share an object, only a rescan attributes the change
+			if (_areaSources > 0) {
+				return false;
+			}
+
+			const auto idx = static_cast<std::ptrdiff_t>(_itemList.SelectedIndex());
+
+			for (const auto& delta : a_deltas) {
+				if (delta.rescan) {
+					return false;
 				}
-				_itemList.InvalidateData();
 
+				const auto object = RE::TESForm::LookupByID<RE::TESBoundObject>(delta.object);
+				if (delta.count == 0 || !object || !CanDisplay(*object)) {
+					continue;
+				}
+
+				const auto row = _store.FindInContainer(delta.object);
+				if (!row) {
+					return false;
+				}
+
+				auto& item = *_itemListImpl[_store.Source(*row)];
+				if (!item.ApplyCountDelta(delta.count)) {
+					return false;
+				}
+
+				_store.Update(*row, item);
+			}
+
+			Diagnostics::Counters::Increment(Diagnostics::Counters::kDeltaUpdates);
+			UpdateItemList(Frame(), idx);
+			return true;
+		}
+
+		// Reorders the rows already in the store, no game data is read again
+		void CycleSortMode()
+		{
+			const auto mode = (Settings::SortMode() + 1) % static_cast<std::uint32_t>(Items::SortMode::kTotal);
+			Settings::SetSortMode(mode);
+			if (!_takeAll && !_store.empty()) {
+				// The mask may predate an in place patch or a settings change, it is rebuilt for the store
+				const auto idx = static_cast<std::ptrdiff_t>(_itemList.SelectedIndex());
+				Items::Filter::Evaluate(_store, Items::Filter::FromSettings(), _selection);
+				_store.Select(_selection);
+				SortAndSearch();
+				_packedItems.Assign(_store);
+				CommitRows();
 				RestoreIndex(idx);
-				UpdateWeight();
 				UpdateInfoBar();
+			}
+		}
 
-				_rootObj.Visible(true);
+		// Searches restrict the store, which a take all job is walking, so they wait for it to finish
+		void BeginSearch()
+		{
+			if (!_takeAll && !_search.Active()) {
+				_search.Begin();
+				_search.Rebase(_store);
+				_textEntry.Enable();
+				ShowSearchResults();
+			}
+		}
+
+		void EndSearch()
+		{
+			NotifySearchEnded();
+			if (_search.Active()) {
+				_search.End();
+				_textEntry.Disable();
+				ShowSearchResults();
+			}
+		}
+
+		void AppendSearch(char32_t a_char)
+		{
+			if (!_takeAll && _search.Active()) {
+				_search.Push(_store, a_char);
+				ShowSearchResults();
+			}
+		}
+
+		void PopSearch()
+		{
+			if (!_takeAll && _search.Active()) {
+				_search.Pop(_store);
+				ShowSearchResults();
 			}
 		}
 
 		void RefreshUI()
 		{
-			RefreshInventory();
-			UpdateTitle();
-			UpdateButtonBar();
+			if (_pending) {
+				return;
+			}
+
+			const auto& frame = Frame();
+			RefreshInventory(frame);
+			UpdateTitle(frame);
+			UpdateButtonBar(frame);
+		}
+
+		// Starts a take all job, which ContinueTakeAll drains a few stacks at a time
+		void TakeAll()
+		{
+			if (_pending) {
+				return;
+			}
+
+			const auto& frame = Frame();
+			if (CloseIfBlocked(frame)) {
+				return;
+			}
+
+			if (frame.dst && !_takeAll && !_store.empty()) {
+				// The job takes what is displayed, a model still out with the workers would replace it midway
+				DiscardClassification();
+				_takeAll.emplace(*frame.dst, frame);
+				_takeAllPos = 0;
+				OnTake(*frame.dst);
+			}
+		}
+
+		// Returns true while a take all job is still running
+		bool ContinueTakeAll()
+		{
+			if (!_takeAll) {
+				return false;
+			}
+
+			// The job keeps no refs between ticks, it borrows this tick's
+			const auto& frame = Frame();
+			if (!frame.dst || CloseIfBlocked(frame)) {
+				_takeAll->Abandon();
+				CancelTakeAll();
+				QueueInventoryRefresh();
+				return false;
+			}
+			_takeAll->Rebind(*frame.dst, frame);
+
+			// Deltas are held back and classification is discarded while the job runs, so the store can't change under it
+			const auto last = std::min(_takeAllPos + TAKE_ALL_BUDGET, _store.size());
+			for (; _takeAllPos < last; ++_takeAllPos) {
+				ItemAt(_takeAllPos).TakeAll(*_takeAll);
+			}
+			_takeAll->Flush();
+
+			if (_takeAllPos < _store.size()) {
+				return true;
+			}
+
+			CancelTakeAll();
+			QueueInventoryRefresh();
+			return false;
 		}
 
 		void TakeStack()
 		{
-			auto dst = _dst.get();
+			if (_takeAll || _pending) {
+				return;
+			}
+
+			const auto& frame = Frame();
+			if (CloseIfBlocked(frame)) {
+				return;
+			}
+
 			auto pos = static_cast<std::ptrdiff_t>(_itemList.SelectedIndex());
-			if (dst && 0 <= pos && pos < std::ssize(_itemListImpl)) {
-				_itemListImpl[static_cast<std::size_t>(pos)]->TakeAll(*dst);
-				_openCloseHandler.Open();
+			if (frame.dst && 0 <= pos && pos < std::ssize(_store)) {
+				auto& item = ItemAt(static_cast<std::size_t>(pos));
+				{
+					Items::TakeTransaction txn{ *frame.dst, frame };
+					item.TakeAll(txn);
+				}
+				OnTake(*frame.dst);
 
-				if (Settings::DispelInvisibility() && dst->AsMagicTarget()) {
-					dst->AsMagicTarget()->DispelEffectsWithArchetype(RE::EffectArchetypes::ArchetypeID::kInvisibility, false);
+				// Container takes come back as deltas, ground items and area rows don't notify the container
+				if (item.InContainer() && _areaSources == 0) {
+					return;
 				}
 			}
 
@@ -189,20 +521,41 @@ namespace Scaleform
 			}
 		}
 
+		// The container's validity is checked on demand through Revalidate, an idle tick resolves nothing
 		void AdvanceMovie(float a_interval, std::uint32_t a_currentTime) override
 		{
-			auto src = _src.get();
-			if (!src || src->IsActivationBlocked()) {
-				Close();
+			Diagnostics::Watchdog::Scope watch{ "LootMenu::AdvanceMovie"sv };
+			Diagnostics::EventTrace::TickScope replay;
+
+			if (_pending) {
+				_dwellRemaining -= a_interval;
+				if (_dwellRemaining <= 0.0F) {
+					_pending = false;
+					_viewHandler->SetSource(Frame());
+					QueueUIRefresh();
+				}
 			}
 
+			_inFrame = true;
 			ProcessDelegate();
+			CollectClassified();
+			Diagnostics::Watchdog::SetRows(_store.size());
+			if (std::exchange(_rowsChanged, false)) {
+				API::Provider::GetSingleton().Publish(_store, _rowsSrc);
+			}
+			ApplyViewModel();
+
+			// Released between ticks so the menu never keeps refs alive on its own
+			_inFrame = false;
+			_frameResolved = false;
+			_frame = {};
+
 			super::AdvanceMovie(a_interval, a_currentTime);
 		}
 
 		void RefreshPlatform() override
 		{
-			UpdateButtonBar();
+			UpdateButtonBar(Frame());
 		}
 
 	private:
@@ -212,58 +565,13 @@ namespace Scaleform
 		public:
 			void LogMessageVarg(LogMessageType, const char* a_fmt, std::va_list a_argList) override
 			{
-				std::string fmt(a_fmt ? a_fmt : "");
-				while (!fmt.empty() && fmt.back() == '\n') {
-					fmt.pop_back();
-				}
-
-				std::va_list args;
-				va_copy(args, a_argList);
-				std::vector<char> buf(static_cast<std::size_t>(std::vsnprintf(0, 0, fmt.c_str(), a_argList) + 1));
-				std::vsnprintf(buf.data(), buf.size(), fmt.c_str(), args);
-				va_end(args);
-
-				logger::info("{}: {}"sv, LootMenu::MenuName(), buf.data());
+				LogSink::GetSingleton().Push(LootMenu::MenuName(), a_fmt, a_argList);
 			}
 		};
 
 		[[nodiscard]] static bool CanDisplay(const RE::TESBoundObject& a_object)
 		{
-			switch (a_object.GetFormType()) {
-			case RE::FormType::Scroll:
-			case RE::FormType::Armor:
-			case RE::FormType::Book:
-			case RE::FormType::Ingredient:
-			case RE::FormType::Misc:
-			case RE::FormType::Weapon:
-			case RE::FormType::Ammo:
-			case RE::FormType::KeyMaster:
-			case RE::FormType::AlchemyItem:
-			case RE::FormType::Note:
-			case RE::FormType::SoulGem:
-				break;
-			case RE::FormType::Light:
-				{
-					auto& light = static_cast<const RE::TESObjectLIGH&>(a_object);
-					if (!light.CanBeCarried()) {
-						return false;
-					}
-				}
-				break;
-			default:
-				return false;
-			}
-
-			if (!a_object.GetPlayable()) {
-				return false;
-			}
-
-			auto name = a_object.GetName();
-			if (!name || name[0] == '\0') {
-				return false;
-			}
-
-			return true;
+			return Items::DisplayFilter::CanDisplay(a_object);
 		}
 
 		void AdjustPosition()
@@ -292,6 +600,20 @@ namespace Scaleform
 
 		}
 
+		// Commits what the job took so far against the current frame
+		void CancelTakeAll()
+		{
+			if (_takeAll) {
+				if (const auto& frame = Frame(); frame.dst) {
+					_takeAll->Rebind(*frame.dst, frame);
+				} else {
+					_takeAll->Abandon();
+				}
+				_takeAll.reset();
+			}
+			_takeAllPos = 0;
+		}
+
 		void Close();
 
 		void InitExtensions()
@@ -305,7 +627,26 @@ namespace Scaleform
 			assert(success);
 		}
 
-		void OnClose() { return; }
+		void OnClose()
+		{
+			CancelTakeAll();
+			EndSearch();
+			_rowsChanged = false;
+			API::Provider::GetSingleton().Clear();
+			if (std::exchange(_pending, false)) {
+				Diagnostics::Counters::Increment(Diagnostics::Counters::kDwellSkipped);
+			}
+			Diagnostics::EventTrace::MenuClosed();
+		}
+
+		void OnTake(RE::Actor& a_dst)
+		{
+			_openCloseHandler.Open();
+
+			if (Settings::DispelInvisibility() && a_dst.AsMagicTarget()) {
+				a_dst.AsMagicTarget()->DispelEffectsWithArchetype(RE::EffectArchetypes::ArchetypeID::kInvisibility, false);
+			}
+		}
 
 		void OnOpen()
 		{
@@ -326,16 +667,24 @@ namespace Scaleform
 				assert(success && instance.IsObject());
 			}
 
+			_view->GetVariable(std::addressof(_searchInput.GetInstance()), "_root.rootObj.searchInput");  // optional
+			if (_searchInput.IsObject()) {
+				_searchInput.Visible(false);
+			}
+
 			AdjustPosition();
 			_rootObj.Visible(false);
 
+			_viewModel.Reset();
 			_title.AutoSize(CLIK::Object{ "left" });
 			_title.Visible(false);
 			_weight.AutoSize(CLIK::Object{ "left" });
 			_weight.Visible(false);
 
-			_view->CreateArray(std::addressof(_itemListProvider));
-			_itemList.DataProvider(CLIK::Array{ _itemListProvider });
+			_strings.Init(*_view);
+			_packedItems.Init(*_view);
+			PackedItemList::SendIconLabels(_strings, _itemList);
+			CommitRows();
 
 			_view->CreateArray(std::addressof(_infoBarProvider));
 			_infoBar.DataProvider(CLIK::Array{ _infoBarProvider });
@@ -346,15 +695,54 @@ namespace Scaleform
 			ProcessDelegate();
 		}
 
+		void NotifySearchEnded();
 		void ProcessDelegate();
 		void QueueInventoryRefresh();
 		void QueueUIRefresh();
 
+		// Resolved at most once per tick, calls from outside a tick resolve every time
+		[[nodiscard]] const FrameContext& Frame()
+		{
+			if (!_frameResolved) {
+				_frame = FrameContext::Resolve(_src, _dst);
+				_frameResolved = _inFrame;
+			}
+			return _frame;
+		}
+
+		void UpdateItemList(const FrameContext& a_frame, std::ptrdiff_t a_oldIdx)
+		{
+			// The close rule counts every row of the container, before filters and search
+			if (_itemListImpl.size() >= 32 || (Settings::CloseWhenEmpty() && _itemListImpl.empty())) {
+				Close();
+			} else {
+				Items::Filter::Evaluate(_store, Items::Filter::FromSettings(), _selection);
+				_store.Select(_selection);
+				SortAndSearch();
+				_packedItems.Assign(_store);
+				CommitRows();
+
+				RestoreIndex(a_oldIdx);
+				UpdateWeight(a_frame);
+				UpdateInfoBar();
+
+				_rootObj.Visible(true);
+			}
+		}
+
+		// Sends the packed rows to the list, plugins reading them through the API hear about it at the end of the tick
+		void CommitRows()
+		{
+			_packedItems.Commit(_itemList);
+			_rowsChanged = true;
+			_rowsSrc = _src;
+		}
+
 		void RestoreIndex(std::ptrdiff_t a_oldIdx)
 		{
-			if (const auto ssize = std::ssize(_itemListImpl); 0 <= a_oldIdx && a_oldIdx < ssize) {
+			if (const auto ssize = std::ssize(_store); 0 <= a_oldIdx && a_oldIdx < ssize) {
 				_itemList.SelectedIndex(static_cast<double>(a_oldIdx));
-			} else if (!_itemListImpl.empty()) {
+			} else if (!_store.empty()) {
 				if (a_oldIdx >= ssize) {
 					_itemList.SelectedIndex(static_cast<double>(ssize) - 1.0);
 				} else {
@@ -365,130 +753,168 @@ namespace Scaleform
 			}
 		}
 
-		void Sort()
+		// Expects the unsearched rows in the store's order
+		void SortAndSearch()
 		{
-			std::stable_sort(
-				_itemListImpl.begin(),
-				_itemListImpl.end(),
-				[&](auto&& a_lhs, auto&& a_rhs) {
-					return *a_lhs < *a_rhs;
-				});
+			_store.Sort(GetSortMode());
+			if (_search.Active()) {
+				_search.Rebase(_store);
+				_store.Restrict(_search.Results());
+			}
 		}
 
-		void UpdateButtonBar()
+		void ShowSearchResults()
 		{
-			if (!_view) {
-				return;
-			}
-
-			const bool stealing = WouldBeStealing();
-			const std::array mappings{
-				std::make_tuple(stealing ? "sSteal"sv : "sTake"sv, "Activate"sv, stealing),
-				std::make_tuple("sSearch"sv, "Ready Weapon"sv, stealing)
-			};
+			_store.Restrict(_search.Results());
+			_packedItems.Assign(_store);
+			CommitRows();
+			RestoreIndex(0);
+			UpdateInfoBar();
+			UpdateTitle(Frame());
+		}
 
-			_buttonBarProvider.ClearElements();
-			auto gmst = RE::GameSettingCollection::GetSingleton();
-			const srell::regex pattern("<.*>(.*)<.*>"s, srell::regex_constants::ECMAScript);
-			for (std::size_t i = 0; i < mappings.size(); ++i) {
-				const auto& mapping = mappings[i];
-
-				auto setting = gmst->GetSetting(std::get<0>(mapping).data());
-				std::string label = setting ? setting->GetString() : "<undefined>"s;
-				srell::smatch matches;
-				if (srell::regex_match(label, matches, pattern)) {
-					if (matches.size() >= 2) {
-						assert(matches.size() == 2);
-						label = matches[1].str();
-					}
-				}
+		[[nodiscard]] static Items::SortMode GetSortMode()
+		{
+			const auto mode = Settings::SortMode();
+			return mode < static_cast<std::uint32_t>(Items::SortMode::kTotal) ?
+			           static_cast<Items::SortMode>(mode) :
+			           Items::SortMode::kDefault;
+		}
 
-				const auto index =
-					static_cast<std::ptrdiff_t>(
-						Input::ControlMap()(std::get<1>(mapping)));
-				const auto stolen = std::get<2>(mapping);
+		[[nodiscard]] Items::Item& ItemAt(std::size_t a_pos)
+		{
+			return *_itemListImpl[_store.Source(_store.Row(a_pos))];
+		}
 
-				RE::GFxValue obj;
-				_view->CreateObject(std::addressof(obj));
-				obj.SetMember("label", { static_cast<std::string_view>(label) });
-				obj.SetMember("index", { index });
-				obj.SetMember("stolen", { stolen });
-				_buttonBarProvider.PushBack(obj);
-			}
-			_buttonBar.InvalidateData();
+		void UpdateButtonBar(const FrameContext& a_frame)
+		{
+			const Input::ControlMap controls;
+			_viewModel.Set(ViewModel::ButtonBarInputs{
+				{ static_cast<std::ptrdiff_t>(controls("Activate"sv)),
+					static_cast<std::ptrdiff_t>(controls("Toggle POV"sv)),
+					static_cast<std::ptrdiff_t>(controls("Ready Weapon"sv)) },
+				WouldBeStealing(a_frame) });
 		}
 
 		void UpdateInfoBar()
 		{
-			_infoBarProvider.ClearElements();
+			ViewModel::InfoBarInputs inputs;
 			const auto idx = static_cast<std::ptrdiff_t>(_itemList.SelectedIndex());
-			if (0 <= idx && idx < std::ssize(_itemListImpl)) {
-				const std::array functors{
-					std::function{ [](const Items::Item& a_val) { return fmt::format(FMT_STRING("{:.1f}"), a_val.Weight()); } },
-					std::function{ [](const Items::Item& a_val) { return fmt::format(FMT_STRING("{}"), a_val.Value()); } },
-				};
-
-				const auto& item = _itemListImpl[static_cast<std::size_t>(idx)];
-				std::string str;
-				RE::GFxValue obj;
-				for (const auto& functor : functors) {
-					str = functor(*item);
-					obj.SetString(str);
-					_infoBarProvider.PushBack(obj);
-				}
-
-				const auto ench = item->EnchantmentCharge();
-				if (ench >= 0.0) {
-					str = fmt::format(FMT_STRING("{:.1f}%"), ench);
-					obj.SetString(str);
-					_infoBarProvider.PushBack(obj);
-				}
+			if (0 <= idx && idx < std::ssize(_store)) {
+				const auto row = _store.Row(static_cast<std::size_t>(idx));
+				inputs.selected = true;
+				inputs.weight = _store.Weight(row);
+				inputs.value = _store.Value(row);
+				inputs.enchantment = ItemAt(static_cast<std::size_t>(idx)).EnchantmentCharge();
 			}
-
-			_infoBar.InvalidateData();
+			_viewModel.Set(std::move(inputs));
 		}
 
-		void UpdateTitle()
+		void UpdateTitle(const FrameContext& a_frame)
 		{
-			auto src = _src.get();
-			if (src) {
-				_title.HTMLText(
-					stl::safe_string(
-						src->GetDisplayFullName()));
-				_title.Visible(true);
+			ViewModel::TitleInputs inputs;
+			inputs.query = _search.Query();
+			inputs.areaSources = _areaSources;
+			inputs.searchActive = _search.Active();
+			inputs.echoQuery = !_searchInput.IsObject();
+			if (const auto& src = a_frame.src; src) {
+				inputs.name = stl::safe_string(src->GetDisplayFullName());
+				inputs.hasSource = true;
 			}
+			_viewModel.Set(std::move(inputs));
 		}
 
-		void UpdateWeight()
+		void UpdateWeight(const FrameContext& a_frame)
 		{
-			auto dst = _dst.get();
+			const auto& dst = a_frame.dst;
 			if (dst && dst->AsActorValueOwner()) {
-				auto inventoryWeight =
-					static_cast<std::ptrdiff_t>(dst->GetWeightInContainer());
-				auto carryWeight =
-					static_cast<std::ptrdiff_t>(dst->AsActorValueOwner()->GetActorValue(RE::ActorValue::kCarryWeight));
-				auto text = std::to_string(inventoryWeight);
-				text += " / ";
-				text += std::to_string(carryWeight);
-				_weight.HTMLText(text);
+				_viewModel.Set(ViewModel::WeightInputs{
+					static_cast<std::ptrdiff_t>(dst->GetWeightInContainer()),
+					static_cast<std::ptrdiff_t>(dst->AsActorValueOwner()->GetActorValue(RE::ActorValue::kCarryWeight)) });
+			}
+		}
+
+		// Rebuilds the widgets whose inputs changed since the last tick
+		void ApplyViewModel()
+		{
+			if (!_view) {
+				return;
+			}
+
+			if (_viewModel.TakeDirty(ViewModel::kTitle)) {
+				const auto& title = _viewModel.Title();
+				if (!title.echoQuery) {
+					_searchInput.Text(title.query);
+					_searchInput.Visible(title.searchActive);
+				}
+
+				if (title.hasSource) {
+					if (title.searchActive && title.echoQuery) {
+						_title.Text(_viewModel.TitleText());
+					} else {
+						_title.HTMLText(_viewModel.TitleText());
+					}
+					_title.Visible(true);
+				}
+			}
+
+			if (_viewModel.TakeDirty(ViewModel::kWeight)) {
+				_weight.HTMLText(_viewModel.WeightText());
 				_weight.Visible(true);
 			}
+
+			if (_viewModel.TakeDirty(ViewModel::kInfoBar)) {
+				_infoBarProvider.ClearElements();
+				RE::GFxValue obj;
+				for (const auto& column : _viewModel.InfoText()) {
+					obj.SetString(column);
+					_infoBarProvider.PushBack(obj);
+				}
+				_infoBar.InvalidateData();
+			}
+
+			if (_viewModel.TakeDirty(ViewModel::kButtonBar)) {
+				const auto& buttons = _viewModel.ButtonBar();
+				const std::array labels{
+					buttons.stealing ? StringTable::kSteal : StringTable::kTake,
+					StringTable::kTakeAll,
+					StringTable::kSearch
+				};
+
+				_buttonBarProvider.ClearElements();
+				for (std::size_t i = 0; i < labels.size(); ++i) {
+					RE::GFxValue obj;
+					_view->CreateObject(std::addressof(obj));
+					obj.SetMember(StringTable::LABEL, _strings[labels[i]]);
+					obj.SetMember(StringTable::INDEX, { buttons.indices[i] });
+					obj.SetMember(StringTable::STOLEN, { buttons.stealing });
+					_buttonBarProvider.PushBack(obj);
+				}
+				_buttonBar.InvalidateData();
+			}
 		}
 
-		[[nodiscard]] bool WouldBeStealing() const
+		[[nodiscard]] static bool WouldBeStealing(const FrameContext& a_frame)
 		{
-			auto dst = _dst.get();
-			auto src = _src.get();
-			return dst && src && dst->WouldBeStealing(src.get());
+			return a_frame.dst && a_frame.src && Items::OwnershipCache::GetSingleton()->WouldBeStealing(*a_frame.src);
 		}
 
 		static constexpr std::string_view FILE_NAME{ "LootMenu" };
 		static constexpr std::string_view MENU_NAME{ "LootMenu" };
 		static constexpr std::int8_t SORT_PRIORITY{ 3 };
+		static constexpr std::size_t TAKE_ALL_BUDGET{ 4 };  // stacks moved per frame
+		static constexpr std::size_t CLASSIFY_INLINE_MAX{ 8 };  // rows not worth a round trip to the workers
+		static constexpr std::size_t AREA_ROW_LIMIT{ 31 };  // UpdateItemList closes the menu at 32 rows
 
 		RE::GPtr<RE::GFxMovieView> _view;
+		StringTable _strings;
 		RE::ActorHandle _dst{ RE::PlayerCharacter::GetSingleton() };
 		RE::ObjectRefHandle _src;
+		FrameContext _frame;
+		bool _inFrame{ false };
+		bool _frameResolved{ false };
+		bool _pending{ false };  // waiting out the crosshair dwell, no rows are built
+		float _dwellRemaining{ 0.0F };  // seconds
 
 		std::optional<ViewHandler> _viewHandler;
 		ContainerChangedHandler _containerChangedHandler;
@@ -497,15 +923,34 @@ namespace Scaleform
 		CLIK::MovieClip _rootObj;
 		CLIK::TextField _title;
 		CLIK::TextField _weight;
+		CLIK::GFx::Controls::TextInput _searchInput;
 
 		CLIK::GFx::Controls::ScrollingList _itemList;
-		RE::GFxValue _itemListProvider;
-		std::vector<std::unique_ptr<Items::Item>> _itemListImpl;
+		PackedItemList _packedItems;
+		Items::ItemArenas _arenas;  // must outlive the item lists below
+		Items::InventoryView _inventory;
+		std::vector<Items::ItemPtr> _itemListImpl;
+		std::vector<Items::ItemPtr> _nextItems;
+		std::vector<RE::ObjectRefHandle> _areaRefs;
+		std::size_t _areaSources{ 0 };  // other containers merged into the rows
+		std::uint64_t _classifyTicket{ 0 };  // the batch _nextItems waits on, 0 when none
+		RE::FormID _classifyContainer{ 0 };
+		std::ptrdiff_t _classifyIdx{ 0 };
+		Items::ItemStore _store;
+		bool _rowsChanged{ false };  // committed since the API last published
+		RE::ObjectRefHandle _rowsSrc;  // _src can move on while the new rows wait out the dwell
+		std::vector<std::uint8_t> _selection;
+		Items::Search _search;
+		Input::TextEntryDisablers _textEntry;
+		std::optional<Items::TakeTransaction> _takeAll;
+		std::size_t _takeAllPos{ 0 };
 
 		CLIK::GFx::Controls::ButtonBar _infoBar;
 		RE::GFxValue _infoBarProvider;
 
 		CLIK::GFx::Controls::ButtonBar _buttonBar;
 		RE::GFxValue _buttonBarProvider;
+
+		ViewModel _viewModel;
 	};
 }
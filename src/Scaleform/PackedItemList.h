@@ -0,0 +1,69 @@
+#pragma once
+
+#include "CLIK/Object.h"
+#include "Items/ItemStore.h"
+#include "Scaleform/StringTable.h"
+
+namespace Scaleform
+{
+	// Hands the item list to LootMenu.ScrollingList as parallel primitive arrays in a single invoke,
+	// the SWF then builds row objects lazily for the visible renderers only
+	class PackedItemList
+	{
+	public:
+		void Init(RE::GFxMovieView& a_view)
+		{
+			for (auto& column : _columns) {
+				a_view.CreateArray(std::addressof(column));
+			}
+		}
+
+		void Assign(const Items::ItemStore& a_store)
+		{
+			const auto order = a_store.Order();
+			const auto size = static_cast<std::uint32_t>(order.size());
+			for (auto& column : _columns) {
+				column.SetArraySize(size);
+			}
+
+			for (std::uint32_t i = 0; i < size; ++i) {
+				const auto row = order[i];
+				_columns[kNames].SetElement(i, { a_store.Name(row) });
+				_columns[kCounts].SetElement(i, { static_cast<double>(a_store.Count(row)) });
+				_columns[kValues].SetElement(i, { static_cast<double>(a_store.Value(row)) });
+				_columns[kWeights].SetElement(i, { static_cast<double>(a_store.Weight(row)) });
+				_columns[kIcons].SetElement(i, { static_cast<double>(a_store.IconIndex(row)) });
+				_columns[kFlags].SetElement(i, { static_cast<double>(a_store.RowFlags(row)) });
+			}
+		}
+
+		void Commit(CLIK::Object& a_list)
+		{
+			[[maybe_unused]] const auto success =
+				a_list.GetInstance().Invoke("setItemsPacked", _columns);
+			assert(success);
+		}
+
+		static void SendIconLabels(const StringTable& a_strings, CLIK::Object& a_list)
+		{
+			std::array<RE::GFxValue, 1> args{ a_strings.IconLabels() };
+			[[maybe_unused]] const auto success =
+				a_list.GetInstance().Invoke("setIconLabels", args);
+			assert(success);
+		}
+
+	private:
+		enum : std::size_t
+		{
+			kNames,
+			kCounts,
+			kValues,
+			kWeights,
+			kIcons,
+			kFlags,
+			kTotal
+		};
+
+		std::array<RE::GFxValue, kTotal> _columns;
+	};
+}
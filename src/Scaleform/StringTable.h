@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Items/GFxItem.h"
+
+namespace Scaleform
+{
+	// Strings that never change for the lifetime of a movie, created as managed movie strings once
+	// so refreshes only reference them instead of copying and hashing the same text every time
+	class StringTable
+	{
+	public:
+		enum Label : std::size_t
+		{
+			kTake,
+			kSteal,
+			kTakeAll,
+			kSearch,
+			kTotalLabels
+		};
+
+		// Member names go through Scaleform's own name table, these just avoid rebuilding them on our side
+		static constexpr const char* LABEL{ "label" };
+		static constexpr const char* INDEX{ "index" };
+		static constexpr const char* STOLEN{ "stolen" };
+
+		void Init(RE::GFxMovieView& a_view)
+		{
+			const auto icons = Items::GFxItem::GetIconLabels();
+			a_view.CreateArray(std::addressof(_iconLabels));
+			_iconLabels.SetArraySize(static_cast<std::uint32_t>(icons.size()));
+			for (std::uint32_t i = 0; i < icons.size(); ++i) {
+				RE::GFxValue str;
+				a_view.CreateString(std::addressof(str), icons[i]);
+				_iconLabels.SetElement(i, str);
+			}
+
+			constexpr std::array<std::string_view, kTotalLabels> settings{
+				"sTake"sv,
+				"sSteal"sv,
+				"sTakeAll"sv,
+				"sSearch"sv
+			};
+
+			auto gmst = RE::GameSettingCollection::GetSingleton();
+			const srell::regex pattern("<.*>(.*)<.*>"s, srell::regex_constants::ECMAScript);
+			for (std::size_t i = 0; i < settings.size(); ++i) {
+				auto setting = gmst ? gmst->GetSetting(settings[i].data()) : nullptr;
+				std::string label = setting ? setting->GetString() : "<undefined>"s;
+				srell::smatch matches;
+				if (srell::regex_match(label, matches, pattern)) {
+					if (matches.size() >= 2) {
+						assert(matches.size() == 2);
+						label = matches[1].str();
+					}
+				}
+
+				a_view.CreateString(std::addressof(_labels[i]), label.c_str());
+			}
+		}
+
+		[[nodiscard]] const RE::GFxValue& IconLabels() const noexcept { return _iconLabels; }
+		[[nodiscard]] const RE::GFxValue& operator[](Label a_label) const noexcept { return _labels[a_label]; }
+
+	private:
+		RE::GFxValue _iconLabels;
+		std::array<RE::GFxValue, kTotalLabels> _labels;
+	};
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+namespace Scaleform
+{
+	// Retained state of the menu's widgets. The menu hands in each widget's inputs as often as it likes,
+	// a widget only turns dirty when they differ from what it last showed, its text is formatted then
+	// and kept. The menu rebuilds the dirty widgets once per tick.
+	class ViewModel
+	{
+	public:
+		enum Widget : std::uint8_t
+		{
+			kTitle = 1 << 0,
+			kWeight = 1 << 1,
+			kInfoBar = 1 << 2,
+			kButtonBar = 1 << 3
+		};
+
+		struct TitleInputs
+		{
+			std::string name;
+			std::string query;
+			std::size_t areaSources{ 0 };
+			bool hasSource{ false };
+			bool searchActive{ false };
+			bool echoQuery{ false };  // older SWFs have no search field, the query goes in the title
+
+			[[nodiscard]] bool operator==(const TitleInputs&) const = default;
+		};
+
+		struct WeightInputs
+		{
+			std::ptrdiff_t inventory{ 0 };
+			std::ptrdiff_t capacity{ 0 };
+
+			[[nodiscard]] bool operator==(const WeightInputs&) const = default;
+		};
+
+		struct InfoBarInputs
+		{
+			bool selected{ false };
+			float weight{ 0.0F };
+			std::int32_t value{ 0 };
+			double enchantment{ -1.0 };  // charge in percent, negative when the row has none
+
+			[[nodiscard]] bool operator==(const InfoBarInputs&) const = default;
+		};
+
+		struct ButtonBarInputs
+		{
+			std::array<std::ptrdiff_t, 3> indices{};  // take, take all, search
+			bool stealing{ false };
+
+			[[nodiscard]] bool operator==(const ButtonBarInputs&) const = default;
+		};
+
+		void Set(TitleInputs&& a_inputs)
+		{
+			if (Assign(_title, std::move(a_inputs), kTitle) && _title->hasSource) {
+				_titleText = _title->name;
+				if (_title->areaSources > 0) {
+					_titleText += fmt::format(FMT_STRING(" (+{})"), _title->areaSources);
+				}
+				if (_title->searchActive && _title->echoQuery) {
+					_titleText = fmt::format(FMT_STRING("{} > {}"), _titleText, _title->query);
+				}
+			}
+		}
+
+		void Set(WeightInputs&& a_inputs)
+		{
+			if (Assign(_weight, std::move(a_inputs), kWeight)) {
+				_weightText = fmt::format(FMT_STRING("{} / {}"), _weight->inventory, _weight->capacity);
+			}
+		}
+
+		void Set(InfoBarInputs&& a_inputs)
+		{
+			if (Assign(_infoBar, std::move(a_inputs), kInfoBar)) {
+				_infoColumns = 0;
+				if (_infoBar->selected) {
+					_infoText[_infoColumns++] = fmt::format(FMT_STRING("{:.1f}"), _infoBar->weight);
+					_infoText[_infoColumns++] = fmt::format(FMT_STRING("{}"), _infoBar->value);
+					if (_infoBar->enchantment >= 0.0) {
+						_infoText[_infoColumns++] = fmt::format(FMT_STRING("{:.1f}%"), _infoBar->enchantment);
+					}
+				}
+			}
+		}
+
+		void Set(ButtonBarInputs&& a_inputs) { Assign(_buttonBar, std::move(a_inputs), kButtonBar); }
+
+		// Forgets what was shown, for a freshly loaded movie
+		void Reset() noexcept
+		{
+			_title.reset();
+			_weight.reset();
+			_infoBar.reset();
+			_buttonBar.reset();
+			_dirty = 0;
+		}
+
+		[[nodiscard]] bool TakeDirty(Widget a_widget) noexcept
+		{
+			const bool dirty = (_dirty & a_widget) != 0;
+			_dirty &= static_cast<std::uint8_t>(~a_widget);
+			return dirty;
+		}
+
+		// Valid once the widget was set
+		[[nodiscard]] const TitleInputs& Title() const { return *_title; }
+		[[nodiscard]] const ButtonBarInputs& ButtonBar() const { return *_buttonBar; }
+
+		[[nodiscard]] const std::string& TitleText() const noexcept { return _titleText; }
+		[[nodiscard]] const std::string& WeightText() const noexcept { return _weightText; }
+		[[nodiscard]] std::span<const std::string> InfoText() const noexcept { return { _infoText.data(), _infoColumns }; }
+
+	private:
+		template <class T>
+		bool Assign(std::optional<T>& a_current, T&& a_next, Widget a_widget)
+		{
+			if (a_current == a_next) {
+				return false;
+			}
+			a_current = std::move(a_next);
+			_dirty |= a_widget;
+			return true;
+		}
+
+		std::optional<TitleInputs> _title;
+		std::optional<WeightInputs> _weight;
+		std::optional<InfoBarInputs> _infoBar;
+		std::optional<ButtonBarInputs> _buttonBar;
+
+		std::string _titleText;
+		std::string _weightText;
+		std::array<std::string, 3> _infoText;
+		std::size_t _infoColumns{ 0 };
+
+		std::uint8_t _dirty{ 0 };
+	};
+}
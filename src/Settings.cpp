@@ -7,11 +7,23 @@ void Settings::LoadSettings()
 	LoadGlobal(settings.m_close_when_empty            , "QLEECloseWhenEmpty");
 	LoadGlobal(settings.m_dispel_invis                , "QLEEDispelInvisibility");
 	LoadGlobal(settings.m_open_when_container_unlocked, "QLEEOpenWhenContainerUnlocked");
+	LoadGlobal(settings.m_crosshair_dwell             , "QLEECrosshairDwellMs");
+	LoadGlobal(settings.m_area_loot_radius            , "QLEEAreaLootRadius");
+	LoadGlobal(settings.m_cache_classification        , "QLEECacheClassification");
+	LoadGlobal(settings.m_hitch_threshold             , "QLEEHitchThresholdMs");
 	LoadGlobal(settings.m_show_book_read              , "QLEEIconShowBookRead");
 	LoadGlobal(settings.m_show_enchanted              , "QLEEIconShowEnchanted");
 	LoadGlobal(settings.m_show_dbm_displayed          , "QLEEIconShowDBMDisplayed");
 	LoadGlobal(settings.m_show_dbm_found              , "QLEEIconShowDBMFound");
 	LoadGlobal(settings.m_show_dbm_new                , "QLEEIconShowDBMNew");
+	LoadGlobal(settings.m_hide_stolen                 , "QLEEHideStolen");
+	LoadGlobal(settings.m_hide_quest_items            , "QLEEHideQuestItems");
+	LoadGlobal(settings.m_hide_read_books             , "QLEEHideReadBooks");
+	LoadGlobal(settings.m_hide_known_enchantments     , "QLEEHideKnownEnchantments");
+	LoadGlobal(settings.m_min_value_per_weight        , "QLEEMinValuePerWeight");
+	LoadGlobal(settings.m_sort_mode                   , "QLEESortMode");
+	LoadGlobal(settings.m_sort_mode_key               , "QLEESortModeKey");
+	LoadGlobal(settings.m_search_key                  , "QLEESearchKey");
 	LoadGlobal(settings.m_disable_for_animals         , "QLEEDisableForAnimals");
 	LoadGlobal(settings.m_window_X                    , "QLEEWindowX");
 	LoadGlobal(settings.m_window_Y                    , "QLEEWindowY");
@@ -49,6 +61,30 @@ bool Settings::DisableForAnimals()
 	return settings.m_disable_for_animals && settings.m_disable_for_animals->value > 0;
 }
 
+float Settings::CrosshairDwellMs()
+{
+	auto& settings = GetSingleton();
+	return settings.m_crosshair_dwell ? settings.m_crosshair_dwell->value : 0.f;
+}
+
+float Settings::AreaLootRadius()
+{
+	auto& settings = GetSingleton();
+	return settings.m_area_loot_radius ? settings.m_area_loot_radius->value : 0.f;
+}
+
+bool Settings::CacheClassification()
+{
+	auto& settings = GetSingleton();
+	return settings.m_cache_classification && settings.m_cache_classification->value > 0;
+}
+
+float Settings::HitchThresholdMs()
+{
+	auto& settings = GetSingleton();
+	return settings.m_hitch_threshold ? settings.m_hitch_threshold->value : 0.f;
+}
+
 bool Settings::ShowBookRead()
 {
 	auto& settings = GetSingleton();
@@ -79,6 +115,62 @@ bool Settings::ShowDBMNew()
 	return settings.m_show_dbm_new && settings.m_show_dbm_new->value > 0;
 }
 
+bool Settings::HideStolen()
+{
+	auto& settings = GetSingleton();
+	return settings.m_hide_stolen && settings.m_hide_stolen->value > 0;
+}
+
+bool Settings::HideQuestItems()
+{
+	auto& settings = GetSingleton();
+	return settings.m_hide_quest_items && settings.m_hide_quest_items->value > 0;
+}
+
+bool Settings::HideReadBooks()
+{
+	auto& settings = GetSingleton();
+	return settings.m_hide_read_books && settings.m_hide_read_books->value > 0;
+}
+
+bool Settings::HideKnownEnchantments()
+{
+	auto& settings = GetSingleton();
+	return settings.m_hide_known_enchantments && settings.m_hide_known_enchantments->value > 0;
+}
+
+float Settings::MinValuePerWeight()
+{
+	auto& settings = GetSingleton();
+	return settings.m_min_value_per_weight ? settings.m_min_value_per_weight->value : 0.f;
+}
+
+std::uint32_t Settings::SortMode()
+{
+	auto& settings = GetSingleton();
+	return settings.m_sort_mode && settings.m_sort_mode->value > 0 ? static_cast<std::uint32_t>(settings.m_sort_mode->value) : 0;
+}
+
+void Settings::SetSortMode(std::uint32_t a_mode)
+{
+	auto& settings = GetSingleton();
+	if (settings.m_sort_mode) {
+		settings.m_sort_mode->value = static_cast<float>(a_mode);
+	}
+}
+
+std::int32_t Settings::SortModeKey()
+{
+	auto& settings = GetSingleton();
+	return settings.m_sort_mode_key ? static_cast<std::int32_t>(settings.m_sort_mode_key->value) : -1;
+}
+
+std::int32_t Settings::SearchKey()
+{
+	auto& settings = GetSingleton();
+	return settings.m_search_key ? static_cast<std::int32_t>(settings.m_search_key->value) : -1;
+}
+
 float Settings::WindowX()
 {
 	auto& settings = GetSingleton();
@@ -107,3 +199,8 @@ void Settings::LoadGlobal(const RE::TESGlobal*& global, const char* editor_id)
 {
 	global = RE::TESForm::LookupByEditorID<RE::TESGlobal>(editor_id);
 }
+
+void Settings::LoadGlobal(RE::TESGlobal*& global, const char* editor_id)
+{
+	global = RE::TESForm::LookupByEditorID<RE::TESGlobal>(editor_id);
+}
@@ -12,6 +12,10 @@ public:
 	static bool DispelInvisibility();
 	static bool OpenWhenContainerUnlocked();
 	static bool DisableForAnimals();
+	static float CrosshairDwellMs();
+	static float AreaLootRadius();
+	static bool CacheClassification();
+	static float HitchThresholdMs();
 
 	static bool ShowBookRead();
 	static bool ShowEnchanted();
@@ -19,6 +23,17 @@ public:
 	static bool ShowDBMFound();
 	static bool ShowDBMNew();
 
+	static bool HideStolen();
+	static bool HideQuestItems();
+	static bool HideReadBooks();
+	static bool HideKnownEnchantments();
+	static float MinValuePerWeight();
+
+	static std::uint32_t SortMode();
+	static void SetSortMode(std::uint32_t a_mode);
+	static std::int32_t SortModeKey();
+	static std::int32_t SearchKey();
+
 	static float WindowX();
 	static float WindowY();
 	static float WindowW();
@@ -26,6 +41,7 @@ public:
 
 private:
 	static void LoadGlobal(const RE::TESGlobal*& global, const char* editor_id);
+	static void LoadGlobal(RE::TESGlobal*& global, const char* editor_id);
 
 	Settings() = default;
 	Settings(Settings&) = delete;
@@ -42,6 +58,10 @@ private:
 	const RE::TESGlobal* m_dispel_invis = nullptr;
 	const RE::TESGlobal* m_open_when_container_unlocked = nullptr;
 	const RE::TESGlobal* m_disable_for_animals = nullptr;
+	const RE::TESGlobal* m_crosshair_dwell = nullptr;
+	const RE::TESGlobal* m_area_loot_radius = nullptr;
+	const RE::TESGlobal* m_cache_classification = nullptr;
+	const RE::TESGlobal* m_hitch_threshold = nullptr;
 
 	const RE::TESGlobal* m_show_book_read = nullptr;
 	const RE::TESGlobal* m_show_enchanted = nullptr;
@@ -49,6 +69,16 @@ private:
 	const RE::TESGlobal* m_show_dbm_found = nullptr;
 	const RE::TESGlobal* m_show_dbm_new = nullptr;
 
+	const RE::TESGlobal* m_hide_stolen = nullptr;
+	const RE::TESGlobal* m_hide_quest_items = nullptr;
+	const RE::TESGlobal* m_hide_read_books = nullptr;
+	const RE::TESGlobal* m_hide_known_enchantments = nullptr;
+	const RE::TESGlobal* m_min_value_per_weight = nullptr;
+
+	RE::TESGlobal* m_sort_mode = nullptr;  // written back when cycled from the hotkey
+	const RE::TESGlobal* m_sort_mode_key = nullptr;
+	const RE::TESGlobal* m_search_key = nullptr;
+
 	const RE::TESGlobal* m_window_X = nullptr;
 	const RE::TESGlobal* m_window_Y = nullptr;
 	const RE::TESGlobal* m_window_W = nullptr;
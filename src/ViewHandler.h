@@ -1,6 +1,9 @@
 #pragma once
 
 #include "Animation/Animation.h"
+#include "Diagnostics/EventTrace.h"
+#include "Diagnostics/Watchdog.h"
+#include "FrameContext.h"
 #include "Input/InputDisablers.h"
 #include "Input/InputListeners.h"
 
@@ -35,10 +38,20 @@ public:
 	ViewHandler& operator=(const ViewHandler&) = default;
 	ViewHandler& operator=(ViewHandler&&) = default;
 
-	void SetSource(RE::ObjectRefHandle a_src)
+	void SetSource(const FrameContext& a_frame)
 	{
-		_src = a_src;
-		Evaluate();
+		_src = a_frame.srcHandle;
+		_deferred = false;
+		Evaluate(a_frame.src.get(), a_frame.dst.get());
+	}
+
+	// The menu waits out the crosshair dwell before it shows anything, until SetSource the game keeps
+	// its own prompt and activation for the ref
+	void DeferSource(const FrameContext& a_frame)
+	{
+		_src = a_frame.srcHandle;
+		_deferred = true;
+		Disable();
 	}
 
 protected:
@@ -46,6 +59,12 @@ protected:
 
 	EventResult ProcessEvent(const RE::MenuOpenCloseEvent* a_event, RE::BSTEventSource<RE::MenuOpenCloseEvent>*) override
 	{
+		Diagnostics::Watchdog::Scope watch{ "ViewHandler::MenuOpenCloseEvent"sv };
+
+		if (a_event) {
+			Diagnostics::EventTrace::RecordMenuOpenClose(*a_event);
+		}
+
 		auto intfcStr = RE::InterfaceStrings::GetSingleton();
 		if (intfcStr 
 			&& a_event 
@@ -99,18 +118,24 @@ private:
 
 	void Evaluate()
 	{
-		const auto controlMap = RE::ControlMap::GetSingleton();
-		const auto menuControls = RE::MenuControls::GetSingleton();
 		const auto src = _src.get();
 		const auto dst = _dst.get();
+		Evaluate(src.get(), dst.get());
+	}
+
+	void Evaluate(RE::TESObjectREFR* a_src, RE::Actor* a_dst)
+	{
+		const auto controlMap = RE::ControlMap::GetSingleton();
+		const auto menuControls = RE::MenuControls::GetSingleton();
 		if (controlMap && menuControls) {
 			const auto& priorityStack = controlMap->contextPriorityStack;
-			if (!src ||
-				src->IsLocked() ||
-				src->IsActivationBlocked() ||
-				!dst ||
-				dst->IsInKillMove() ||
-				dst->GetOccupiedFurniture() ||
+			if (_deferred ||
+				!a_src ||
+				a_src->IsLocked() ||
+				a_src->IsActivationBlocked() ||
+				!a_dst ||
+				a_dst->IsInKillMove() ||
+				a_dst->GetOccupiedFurniture() ||
 				menuControls->InBeastForm() ||
 				priorityStack.empty() ||
 				priorityStack.back() != RE::UserEvents::INPUT_CONTEXT_ID::kGameplay) {
@@ -236,4 +261,5 @@ private:
 	RE::ObjectRefHandle _src;
 	RE::ActorHandle _dst;
 	bool _enabled{ false };
+	bool _deferred{ false };
 };
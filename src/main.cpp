@@ -1,10 +1,19 @@
 #include "Animation/Animation.h"
+#include "API/Provider.h"
+#include "Area/LootableGrid.h"
+#include "Diagnostics/Counters.h"
+#include "Diagnostics/EventTrace.h"
+#include "Diagnostics/Watchdog.h"
 #include "Events/Events.h"
 #include "Hooks.h"
 #include "Input/Input.h"
 #include "Loot.h"
 #include "Scaleform/Scaleform.h"
 #include "LOTD/LOTD.h"
+#include "Items/ClassCache.h"
+#include "Items/Collation.h"
+#include "Items/DisplayFilter.h"
+#include "Items/Filter.h"
 #include "Items/GFxItem.h"
 
 namespace
@@ -62,6 +71,18 @@ namespace
 				case Keyboard::kNum9:
 					loot.Disable();
 					break;
+				case Keyboard::kNum8:
+					Diagnostics::Counters::Dump();
+					break;
+				case Keyboard::kNum7:
+					Diagnostics::EventTrace::ToggleRecording();
+					break;
+				case Keyboard::kNum6:
+					Diagnostics::EventTrace::Replay();
+					break;
+				case Keyboard::kNum5:
+					Diagnostics::Watchdog::Dump();
+					break;
 				default:
 					break;
 				}
@@ -81,6 +102,18 @@ namespace
 		InputHandler& operator=(InputHandler&&) = delete;
 	};
 
+	void DumpHitches(RE::StaticFunctionTag*)
+	{
+		Diagnostics::Watchdog::Dump();
+	}
+
+	// Natives of the QuickLootEE script, for the MCM
+	bool RegisterFuncs(RE::BSScript::IVirtualMachine* a_vm)
+	{
+		a_vm->RegisterFunction("DumpHitches"sv, "QuickLootEE"sv, DumpHitches);
+		return true;
+	}
+
 	void MessageHandler(SKSE::MessagingInterface::Message* a_msg)
 	{
 		switch (a_msg->type) {
@@ -96,6 +129,14 @@ namespace
 
 			Settings::LoadSettings();
 			LOTD::LoadLists();
+			Items::Collation::Init();
+			Items::ClassCache::Init();
+			Items::DisplayFilter::Init();
+			logger::info("Row filter using {} path"sv, Items::Filter::PathName());
+			break;
+		case SKSE::MessagingInterface::kPreLoadGame:
+		case SKSE::MessagingInterface::kNewGame:
+			Area::LootableGrid::GetSingleton()->Clear();
 			break;
 		case SKSE::MessagingInterface::kPostPostLoad:
 		{
@@ -167,6 +208,13 @@ SKSEPluginLoad(const SKSE::LoadInterface* a_skse)
 		return false;
 	}
 
+	API::Provider::Register();
+
+	auto papyrus = SKSE::GetPapyrusInterface();
+	if (!papyrus->Register(RegisterFuncs)) {
+		return false;
+	}
+
 	Hooks::Install();
 
 	return true;
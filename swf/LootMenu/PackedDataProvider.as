@@ -0,0 +1,147 @@
+class LootMenu.PackedDataProvider
+{
+	/* CONSTANTS */
+
+	// Bits of the flags column, keep in sync with Items::RowFlag
+	private static var STOLEN: Number = 1 << 0;
+	private static var ENCHANTED: Number = 1 << 1;
+	private static var KNOWN_ENCHANTED: Number = 1 << 2;
+	private static var SPECIAL_ENCHANTED: Number = 1 << 3;
+	private static var READ: Number = 1 << 4;
+	private static var DBM_NEW: Number = 1 << 5;
+	private static var DBM_FOUND: Number = 1 << 6;
+	private static var DBM_DISPLAYED: Number = 1 << 7;
+	private static var HAS_WEIGHT: Number = 1 << 8;
+
+
+	/* PRIVATE VARIABLES */
+
+	private var _names: Array;
+	private var _counts: Array;
+	private var _values: Array;
+	private var _weights: Array;
+	private var _icons: Array;
+	private var _flags: Array;
+	private var _iconLabels: Array;
+	private var _rows: Array;
+
+
+	/* PUBLIC VARIABLES */
+
+	public var isDataProvider: Boolean = true;
+
+
+	/* INITIALIZATION */
+
+	public function PackedDataProvider(a_names: Array, a_counts: Array, a_values: Array, a_weights: Array, a_icons: Array, a_flags: Array, a_iconLabels: Array)
+	{
+		_names = a_names;
+		_counts = a_counts;
+		_values = a_values;
+		_weights = a_weights;
+		_icons = a_icons;
+		_flags = a_flags;
+		_iconLabels = a_iconLabels != null ? a_iconLabels : new Array();
+		_rows = new Array();
+	}
+
+
+	/* PROPERTIES */
+
+	public function get length(): Number
+	{
+		return _names != null ? _names.length : 0;
+	}
+
+
+	/* PUBLIC FUNCTIONS */
+
+	public function requestItemAt(a_index: Number, a_scope: Object, a_callBack: String): Object
+	{
+		var row: Object = getRow(a_index);
+		if (a_scope != null && a_callBack != null) {
+			a_scope[a_callBack].call(a_scope, row);
+		}
+		return row;
+	}
+
+	public function requestItemRange(a_startIndex: Number, a_endIndex: Number, a_scope: Object, a_callBack: String): Array
+	{
+		var rows: Array = new Array();
+		for (var i: Number = a_startIndex; i <= a_endIndex; i++) {
+			rows.push(getRow(i));
+		}
+
+		if (a_scope != null && a_callBack != null) {
+			a_scope[a_callBack].call(a_scope, rows);
+		}
+		return rows;
+	}
+
+	public function indexOf(a_value: Object, a_scope: Object, a_callBack: String): Number
+	{
+		var index: Number = -1;
+		for (var i: Number = 0; i < _rows.length; i++) {
+			if (_rows[i] == a_value) {
+				index = i;
+				break;
+			}
+		}
+
+		if (a_scope != null && a_callBack != null) {
+			a_scope[a_callBack].call(a_scope, index);
+		}
+		return index;
+	}
+
+	public function addEventListener(a_event: String, a_scope: Object, a_callBack: String): Void {}
+
+	public function removeEventListener(a_event: String, a_scope: Object, a_callBack: String): Void {}
+
+	public function cleanUp(): Void
+	{
+		_rows = new Array();
+	}
+
+
+	/* PRIVATE FUNCTIONS */
+
+	// Unpacks one row into the object layout ListItemRenderer expects, on first request only
+	private function getRow(a_index: Number): Object
+	{
+		if (a_index < 0 || a_index >= length) {
+			return null;
+		}
+
+		var row: Object = _rows[a_index];
+		if (row != null) {
+			return row;
+		}
+
+		var flags: Number = _flags[a_index];
+		row = {
+			displayName: _names[a_index],
+			count: _counts[a_index],
+			value: _values[a_index],
+			stolen: (flags & STOLEN) != 0,
+			iconLabel: _iconLabels[_icons[a_index]],
+			dbmNew: (flags & DBM_NEW) != 0,
+			dbmFound: (flags & DBM_FOUND) != 0,
+			dbmDisp: (flags & DBM_DISPLAYED) != 0,
+			isRead: (flags & READ) != 0
+		};
+
+		if ((flags & HAS_WEIGHT) != 0) {
+			row.weight = _weights[a_index];
+		}
+
+		if ((flags & ENCHANTED) != 0) {
+			row.enchanted = true;
+			row.knownEnchanted = (flags & KNOWN_ENCHANTED) != 0;
+			row.specialEnchanted = (flags & SPECIAL_ENCHANTED) != 0;
+		}
+
+		_rows[a_index] = row;
+		return row;
+	}
+}
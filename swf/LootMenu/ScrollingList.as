@@ -1,5 +1,12 @@
-﻿class LootMenu.ScrollingList extends gfx.controls.ScrollingList
+﻿import LootMenu.PackedDataProvider;
+
+class LootMenu.ScrollingList extends gfx.controls.ScrollingList
 {
+	/* PRIVATE VARIABLES */
+
+	private var _iconLabels: Array;
+
+
 	/* INITIALIZATION */
 
 	// @override gfx.controls.ScrollingList
@@ -16,6 +23,17 @@
 		selectedIndex = clamp(_selectedIndex + totalRenderers * a_page, 0, _dataProvider.length - 1);
 	}
 
+	public function setIconLabels(a_labels: Array): Void
+	{
+		_iconLabels = a_labels;
+	}
+
+	// Columns are parallel arrays, one element per row
+	public function setItemsPacked(a_names: Array, a_counts: Array, a_values: Array, a_weights: Array, a_icons: Array, a_flags: Array): Void
+	{
+		dataProvider = new PackedDataProvider(a_names, a_counts, a_values, a_weights, a_icons, a_flags, _iconLabels);
+	}
+
 
 	/* PRIVATE FUNCTIONS */
 